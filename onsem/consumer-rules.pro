@@ -0,0 +1,33 @@
+# Rules given to the apps that use this library, so that their shrinking keeps the classes and the members
+# that the native code finds by their names. (cf javabindings.cpp and semanticenumsindexes.cpp)
+
+# The native functions are bound by the names of their classes and of their methods
+-keepclasseswithmembernames,includedescriptorclasses class com.onsem.** {
+    native <methods>;
+}
+
+-keep class com.onsem.DisposableWithId {
+    int id;
+}
+-keep class com.onsem.SemanticExpression {
+    <init>(int);
+}
+-keep class com.onsem.ExpressionWithLinks {
+    <init>(int);
+}
+-keep class com.onsem.Recommendation {
+    <init>(java.lang.String, int);
+}
+-keep class com.onsem.JiniOutputter {
+    void decodeExecutionEvents(java.nio.ByteBuffer);
+}
+-keep class com.onsem.NativeCallback {
+    boolean isCancelled;
+    void onSuccess(java.lang.Object);
+    void onFailure(java.lang.Throwable);
+}
+
+# The values of the enums are read by their names
+-keep enum com.onsem.** {
+    *;
+}
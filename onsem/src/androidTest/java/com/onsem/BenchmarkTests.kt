@@ -0,0 +1,224 @@
+package com.onsem
+
+import android.content.Context
+import android.content.res.AssetManager
+import android.util.Log
+import androidx.test.platform.app.InstrumentationRegistry
+import org.junit.Assert.*
+import org.junit.Test
+import java.io.File
+import java.util.*
+import kotlin.concurrent.thread
+
+class BenchmarkTests {
+
+    private val locale = Locale.FRENCH
+
+    /// Load a linguistic database, and return the elapsed time in milliseconds.
+    private fun loadLinguisticDatabase(assetManager: AssetManager, useMemoryMappedAssets: Boolean): Long {
+        val begin = System.nanoTime()
+        val linguisticDb = LinguisticDatabase(assetManager, useMemoryMappedAssets = useMemoryMappedAssets)
+        val elapsedTime = (System.nanoTime() - begin) / 1_000_000
+        linguisticDb.dispose()
+        return elapsedTime
+    }
+
+    @Test
+    fun linguisticDatabaseLoading() {
+        val targetContext: Context = InstrumentationRegistry.getInstrumentation().targetContext
+        val nbOfLoadings = 3
+        var streamingTime = 0L
+        var mappedTime = 0L
+        // Alternate the backends so that they both benefit from the file cache of the system
+        for (i in 0 until nbOfLoadings) {
+            streamingTime += loadLinguisticDatabase(targetContext.assets, false)
+            mappedTime += loadLinguisticDatabase(targetContext.assets, true)
+        }
+        Log.i("OnsemBenchmark", "linguistic database loading, streaming: ${streamingTime / nbOfLoadings}ms, " +
+                "memory mapped: ${mappedTime / nbOfLoadings}ms")
+    }
+
+    @Test
+    fun jniCallOverhead() {
+        val targetContext: Context = InstrumentationRegistry.getInstrumentation().targetContext
+        val linguisticDb = LinguisticDatabase(targetContext.assets)
+        val semanticMemory = SemanticMemory()
+        val textProcessingContext = TextProcessingContext(toRobot = true, locale)
+        val semExp = textToSemanticExpression("saute", textProcessingContext, SemanticSourceEnum.UNKNOWN,
+            semanticMemory, linguisticDb)
+
+        // categorize is cheap on the C++ side, so it mainly measures the cost of the JNI layer
+        val nbOfCalls = 10_000
+        val begin = System.nanoTime()
+        for (i in 0 until nbOfCalls)
+            assertEquals(ExpressionCategory.COMMAND, categorize(semExp))
+        val elapsedTime = System.nanoTime() - begin
+        Log.i("OnsemBenchmark", "categorize: ${elapsedTime / nbOfCalls}ns per call")
+
+        semExp.dispose()
+        textProcessingContext.dispose()
+        semanticMemory.dispose()
+        linguisticDb.dispose()
+    }
+
+    /// Run the pure operations on several threads, and return the number of operations per second.
+    private fun measurePureOperations(nbOfThreads: Int, semExp: SemanticExpression,
+                                      linguisticDb: LinguisticDatabase): Long {
+        val nbOfCallsPerThread = 2_000
+        val begin = System.nanoTime()
+        (0 until nbOfThreads).map {
+            thread {
+                for (i in 0 until nbOfCallsPerThread) {
+                    categorize(semExp)
+                    isAName("Paul", linguisticDb)
+                    getLocaleFromText("Je suis content de vous voir", linguisticDb)
+                }
+            }
+        }.forEach { it.join() }
+        val elapsedTime = System.nanoTime() - begin
+        return 3L * nbOfCallsPerThread * nbOfThreads * 1_000_000_000 / elapsedTime.coerceAtLeast(1)
+    }
+
+    @Test
+    fun pureOperationsScaling() {
+        val targetContext: Context = InstrumentationRegistry.getInstrumentation().targetContext
+        val linguisticDb = LinguisticDatabase(targetContext.assets)
+        val semanticMemory = SemanticMemory()
+        val textProcessingContext = TextProcessingContext(toRobot = true, locale)
+        val semExp = textToSemanticExpression("saute", textProcessingContext, SemanticSourceEnum.UNKNOWN,
+            semanticMemory, linguisticDb)
+
+        // The pure operations share no lock, so the throughput should grow with the threads up to the number of cores
+        measurePureOperations(1, semExp, linguisticDb)
+        val oneThreadThroughput = measurePureOperations(1, semExp, linguisticDb)
+        val maxNbOfThreads = Runtime.getRuntime().availableProcessors().coerceIn(2, 8)
+        var nbOfThreads = 1
+        while (nbOfThreads <= maxNbOfThreads) {
+            val throughput = if (nbOfThreads == 1) oneThreadThroughput else
+                measurePureOperations(nbOfThreads, semExp, linguisticDb)
+            Log.i("OnsemBenchmark", "pure operations, $nbOfThreads threads: $throughput calls/s, " +
+                    "speedup: ${throughput.toDouble() / oneThreadThroughput.coerceAtLeast(1)}")
+            nbOfThreads *= 2
+        }
+
+        semExp.dispose()
+        textProcessingContext.dispose()
+        semanticMemory.dispose()
+        linguisticDb.dispose()
+    }
+
+    /// Return the mean time of a recommendation lookup in microseconds.
+    private fun measureRecommendations(recommendationsFinder: RecommendationsFinder, semExp: SemanticExpression,
+                                       linguisticDb: LinguisticDatabase, useIndex: Boolean): Long {
+        val nbOfLookups = 20
+        val begin = System.nanoTime()
+        for (i in 0 until nbOfLookups)
+            recommendationsFinder.getTopRecommendations(semExp, linguisticDb, useIndex = useIndex)
+        return (System.nanoTime() - begin) / 1_000 / nbOfLookups
+    }
+
+    @Test
+    fun recommendationsAgainstRecommendationCount() {
+        val targetContext: Context = InstrumentationRegistry.getInstrumentation().targetContext
+        val linguisticDb = LinguisticDatabase(targetContext.assets)
+        val semanticMemory = SemanticMemory()
+        val verbs = listOf("ouvrir", "fermer", "allumer", "éteindre", "prendre", "poser", "montrer", "chercher", "ranger", "nettoyer")
+        val objects = listOf("la boîte", "la porte", "la lumière", "le livre", "la fenêtre", "le placard", "la télé", "le sac")
+        val recommendationsFinder = RecommendationsFinder(linguisticDb)
+        val textProcessingContext = TextProcessingContext(toRobot = true, locale)
+        val semExp = textToSemanticExpression("je veux ouvrir la boîte numéro 3", textProcessingContext,
+            SemanticSourceEnum.UNKNOWN, semanticMemory, linguisticDb)
+        var nbOfRecommendations = 0
+        for (nbOfRecommendationsToMeasure in listOf(1_000, 10_000, 100_000)) {
+            while (nbOfRecommendations < nbOfRecommendationsToMeasure) {
+                val verb = verbs[nbOfRecommendations % verbs.size]
+                val obj = objects[(nbOfRecommendations / verbs.size) % objects.size]
+                recommendationsFinder.addRecommendation("Je veux $verb $obj numéro ${nbOfRecommendations / 80}",
+                    "recommendation-$nbOfRecommendations", locale, linguisticDb)
+                ++nbOfRecommendations
+            }
+            // The index ranks the recommendations differently (cf getTopRecommendations),
+            // so these are the durations of two different rankings, not of two ways to compute the same one
+            val currentPathTime = measureRecommendations(recommendationsFinder, semExp, linguisticDb, false)
+            val indexTime = measureRecommendations(recommendationsFinder, semExp, linguisticDb, true)
+            Log.i("OnsemBenchmark", "$nbOfRecommendationsToMeasure recommendations, " +
+                    "current path: ${currentPathTime}us, index: ${indexTime}us")
+        }
+        semExp.dispose()
+        textProcessingContext.dispose()
+        recommendationsFinder.dispose()
+        semanticMemory.dispose()
+        linguisticDb.dispose()
+    }
+
+    @Test
+    fun recommendationsFinderConstruction() {
+        val targetContext: Context = InstrumentationRegistry.getInstrumentation().targetContext
+        val linguisticDb = LinguisticDatabase(targetContext.assets)
+        val verbs = listOf("ouvrir", "fermer", "allumer", "éteindre", "prendre", "poser", "montrer", "chercher", "ranger", "nettoyer")
+        val nbOfRecommendations = 2_000
+        val texts = Array(nbOfRecommendations) { "Je veux ${verbs[it % verbs.size]} la boîte numéro ${it / verbs.size}" }
+        val ids = Array(nbOfRecommendations) { "recommendation-$it" }
+        val file = File(targetContext.cacheDir, "benchmark-recommendations.bin")
+
+        var begin = System.nanoTime()
+        val recommendationsFinder = RecommendationsFinder(linguisticDb)
+        for (i in texts.indices)
+            recommendationsFinder.addRecommendation(texts[i], ids[i], locale, linguisticDb)
+        val oneByOneTime = (System.nanoTime() - begin) / 1_000_000
+        recommendationsFinder.dispose()
+
+        begin = System.nanoTime()
+        val bulkRecommendationsFinder = RecommendationsFinder(linguisticDb)
+        bulkRecommendationsFinder.addRecommendationsBulk(texts, ids, locale, linguisticDb)
+        val bulkTime = (System.nanoTime() - begin) / 1_000_000
+        bulkRecommendationsFinder.save(file)
+        bulkRecommendationsFinder.dispose()
+
+        begin = System.nanoTime()
+        val loadedRecommendationsFinder = loadRecommendationsFinder(file, linguisticDb)
+        val loadingTime = (System.nanoTime() - begin) / 1_000_000
+        loadedRecommendationsFinder.dispose()
+        Log.i("OnsemBenchmark", "$nbOfRecommendations recommendations, one by one: ${oneByOneTime}ms, " +
+                "bulk: ${bulkTime}ms, loaded from a file: ${loadingTime}ms")
+        file.delete()
+        linguisticDb.dispose()
+    }
+
+    /// Return the mean time of a trigger matching in microseconds.
+    private fun measureTriggerMatching(input: String, semanticMemory: SemanticMemory, linguisticDb: LinguisticDatabase): Long {
+        val textProcessingContext = TextProcessingContext(toRobot = true, locale)
+        val semExp = textToSemanticExpression(input, textProcessingContext, SemanticSourceEnum.UNKNOWN,
+            semanticMemory, linguisticDb)
+        val nbOfMatchings = 20
+        val begin = System.nanoTime()
+        for (i in 0 until nbOfMatchings)
+            reactFromTrigger(semExp, locale, semanticMemory, linguisticDb, JiniOutputter())
+        val elapsedTime = (System.nanoTime() - begin) / 1_000 / nbOfMatchings
+        semExp.dispose()
+        textProcessingContext.dispose()
+        return elapsedTime
+    }
+
+    @Test
+    fun triggerMatchingAgainstTriggerCount() {
+        val targetContext: Context = InstrumentationRegistry.getInstrumentation().targetContext
+        val linguisticDb = LinguisticDatabase(targetContext.assets)
+        val verbs = listOf("ouvre", "ferme", "allume", "éteins", "prends", "pose", "montre", "cherche", "range", "nettoie")
+        val semanticMemory = SemanticMemory()
+        var nbOfTriggers = 0
+        for (catalogSize in listOf(10, 100, 1000)) {
+            while (nbOfTriggers < catalogSize) {
+                addTrigger("${verbs[nbOfTriggers % verbs.size]} la boîte numéro ${nbOfTriggers / verbs.size}",
+                    "d'accord", locale, semanticMemory, linguisticDb)
+                ++nbOfTriggers
+            }
+            val matchingTime = measureTriggerMatching("ouvre la boîte numéro 0", semanticMemory, linguisticDb)
+            val notMatchingTime = measureTriggerMatching("chante une chanson", semanticMemory, linguisticDb)
+            Log.i("OnsemBenchmark", "$catalogSize triggers, matching: ${matchingTime}us, " +
+                    "not matching: ${notMatchingTime}us")
+        }
+        semanticMemory.dispose()
+        linguisticDb.dispose()
+    }
+}
@@ -0,0 +1,208 @@
+package com.onsem
+
+import android.content.Context
+import android.util.Log
+import androidx.test.platform.app.InstrumentationRegistry
+import kotlinx.coroutines.async
+import kotlinx.coroutines.awaitAll
+import kotlinx.coroutines.runBlocking
+import org.junit.Assert.*
+import org.junit.Test
+import java.util.*
+import kotlin.concurrent.thread
+
+class ConcurrencyTests {
+
+    private val locale = Locale.FRENCH
+    private val nbOfIterations = 20
+
+    private fun reactFromTriggerStr(input: String, semanticMemory: SemanticMemory, linguisticDb: LinguisticDatabase): String {
+        val textProcessingContext = TextProcessingContext(toRobot = true, locale)
+        val semExp = textToSemanticExpression(input, textProcessingContext, SemanticSourceEnum.UNKNOWN,
+            semanticMemory, linguisticDb)
+        val jiniOutputter = JiniOutputter()
+        reactFromTrigger(semExp, locale, semanticMemory, linguisticDb, jiniOutputter)
+        semExp.dispose()
+        textProcessingContext.dispose()
+        return jiniOutputter.rootExecutionData.toStr()
+    }
+
+    private fun newMemoryWithATrigger(linguisticDb: LinguisticDatabase): SemanticMemory {
+        val semanticMemory = SemanticMemory()
+        addTriggerToAResource("Avance", "mission", "avance-id",
+            mapOf("distance" to arrayOf("combien de mètres")), locale, semanticMemory, linguisticDb)
+        return semanticMemory
+    }
+
+    /// Run the reactions of each memory, and return the elapsed time in milliseconds.
+    private fun runReactions(memories: List<SemanticMemory>, linguisticDb: LinguisticDatabase, inParallel: Boolean): Long {
+        val errors = Collections.synchronizedList(mutableListOf<String>())
+        val reactionsOfAMemory = { semanticMemory: SemanticMemory ->
+            for (i in 0 until nbOfIterations) {
+                val res = reactFromTriggerStr("Avance de 30 centimètres", semanticMemory, linguisticDb)
+                if (res != "onResource(mission, avance-id, {distance=0,3 mètre})")
+                    errors.add(res)
+            }
+        }
+        val begin = System.nanoTime()
+        if (inParallel)
+            memories.map { thread { reactionsOfAMemory(it) } }.forEach { it.join() }
+        else
+            memories.forEach { reactionsOfAMemory(it) }
+        val elapsedTime = (System.nanoTime() - begin) / 1_000_000
+        assertEquals(listOf<String>(), errors)
+        return elapsedTime
+    }
+
+    @Test
+    fun reactionsOnDisjointMemoriesInParallel() {
+        val targetContext: Context = InstrumentationRegistry.getInstrumentation().targetContext
+        val linguisticDb = LinguisticDatabase(targetContext.assets)
+        val nbOfThreads = Runtime.getRuntime().availableProcessors().coerceIn(2, 8)
+        val memories = (0 until nbOfThreads).map { newMemoryWithATrigger(linguisticDb) }
+
+        val sequentialTime = runReactions(memories, linguisticDb, false)
+        val parallelTime = runReactions(memories, linguisticDb, true)
+        Log.i("OnsemBenchmark", "$nbOfThreads memories, sequential: ${sequentialTime}ms, parallel: ${parallelTime}ms, " +
+                "speedup: ${sequentialTime.toDouble() / parallelTime.coerceAtLeast(1)}")
+
+        memories.forEach { it.dispose() }
+        linguisticDb.dispose()
+    }
+
+    /// Results of the operations that do not lock the memory, they have to be the same in all the threads.
+    private fun pureOperationsResults(semExp: SemanticExpression, semanticMemory: SemanticMemory,
+                                      linguisticDb: LinguisticDatabase): List<String> {
+        val textProcessingContext = TextProcessingContext(toRobot = true, locale)
+        val parsedSemExp = textToSemanticExpression("Avance de 30 centimètres", textProcessingContext,
+            SemanticSourceEnum.UNKNOWN, semanticMemory, linguisticDb)
+        val notKnowingSemExp = notKnowing(semExp, semanticMemory, linguisticDb)
+        val res = listOf(
+            isAName("Paul", linguisticDb).toString(),
+            categorize(semExp).toString(),
+            categorize(parsedSemExp).toString(),
+            getLocaleFromText("Je suis content de vous voir", linguisticDb),
+            (notKnowingSemExp != null).toString())
+        notKnowingSemExp?.dispose()
+        parsedSemExp.dispose()
+        textProcessingContext.dispose()
+        return res
+    }
+
+    @Test
+    fun pureOperationsInParallel() {
+        val targetContext: Context = InstrumentationRegistry.getInstrumentation().targetContext
+        val linguisticDb = LinguisticDatabase(targetContext.assets)
+        val semanticMemory = SemanticMemory()
+        val textProcessingContext = TextProcessingContext(toRobot = true, locale)
+        val semExp = textToSemanticExpression("saute", textProcessingContext, SemanticSourceEnum.UNKNOWN,
+            semanticMemory, linguisticDb)
+        val expectedResults = pureOperationsResults(semExp, semanticMemory, linguisticDb)
+
+        // The memory is modified meanwhile, the pure operations do not wait for it
+        val nbOfThreads = Runtime.getRuntime().availableProcessors().coerceIn(2, 8)
+        val errors = Collections.synchronizedList(mutableListOf<List<String>>())
+        val writer = thread {
+            for (i in 0 until nbOfIterations)
+                addTrigger("chante numéro $i", "d'accord", locale, semanticMemory, linguisticDb)
+        }
+        (0 until nbOfThreads).map {
+            thread {
+                for (i in 0 until nbOfIterations) {
+                    val results = pureOperationsResults(semExp, semanticMemory, linguisticDb)
+                    if (results != expectedResults)
+                        errors.add(results)
+                }
+            }
+        }.forEach { it.join() }
+        writer.join()
+        assertEquals(listOf<List<String>>(), errors)
+
+        semExp.dispose()
+        textProcessingContext.dispose()
+        semanticMemory.dispose()
+        linguisticDb.dispose()
+    }
+
+    @Test
+    fun asynchronousAnswers() {
+        val targetContext: Context = InstrumentationRegistry.getInstrumentation().targetContext
+        val linguisticDb = LinguisticDatabase(targetContext.assets)
+        val semanticMemory = SemanticMemory()
+        val textProcessingContext = TextProcessingContext(toRobot = true, locale)
+        val affirmation = textToSemanticExpression("Paul est mon ami", textProcessingContext,
+            SemanticSourceEnum.UNKNOWN, semanticMemory, linguisticDb)
+        val question = textToSemanticExpression("Qui est mon ami ?", textProcessingContext,
+            SemanticSourceEnum.UNKNOWN, semanticMemory, linguisticDb)
+
+        runBlocking {
+            // The operations on the same memory are run in the order of the calls
+            val informResult = async { informAsync(affirmation, locale, semanticMemory, linguisticDb, JiniOutputter(), false) }
+            val answers = (0 until 10).map { async { answerAsync(question, semanticMemory, linguisticDb) } }
+            informResult.await()?.dispose()
+            answers.awaitAll().forEach { answer ->
+                assertNotNull(answer)
+                answer!!.dispose()
+            }
+        }
+
+        question.dispose()
+        affirmation.dispose()
+        textProcessingContext.dispose()
+        semanticMemory.dispose()
+        linguisticDb.dispose()
+    }
+
+    @Test
+    fun answerOrNotKnowing() {
+        val targetContext: Context = InstrumentationRegistry.getInstrumentation().targetContext
+        val linguisticDb = LinguisticDatabase(targetContext.assets)
+        val semanticMemory = SemanticMemory()
+        val textProcessingContext = TextProcessingContext(toRobot = true, locale)
+        val semExp = textToSemanticExpression("saute", textProcessingContext,
+            SemanticSourceEnum.UNKNOWN, semanticMemory, linguisticDb)
+
+        val answer = runBlocking { answerAsyncOrNotKnowing(semExp, semanticMemory, linguisticDb, 10_000) }
+        assertEquals("Je ne sais pas sauter.",
+            semanticExpressionToTextAndConsume(answer!!, locale, semanticMemory, linguisticDb))
+
+        semExp.dispose()
+        textProcessingContext.dispose()
+        semanticMemory.dispose()
+        linguisticDb.dispose()
+    }
+
+    @Test
+    fun reactionsWithDeadline() {
+        val targetContext: Context = InstrumentationRegistry.getInstrumentation().targetContext
+        val linguisticDb = LinguisticDatabase(targetContext.assets)
+        val semanticMemory = newMemoryWithATrigger(linguisticDb)
+        val textProcessingContext = TextProcessingContext(toRobot = true, locale)
+        val semExp = textToSemanticExpression("Avance de 30 centimètres", textProcessingContext,
+            SemanticSourceEnum.UNKNOWN, semanticMemory, linguisticDb)
+        val operators = arrayOf(SemanticOperator.REACTFROMTRIGGER)
+
+        runBlocking {
+            // An operation that is not started at the deadline is skipped
+            val lateOutputter = JiniOutputter()
+            assertEquals(ContextualAnnotation.ANSWERNOTFOUND,
+                callOperatorsAsyncWithDeadline(operators, semExp, locale, semanticMemory, linguisticDb,
+                    lateOutputter, 0, ContextualAnnotation.ANSWERNOTFOUND))
+            assertEquals(null, informAsyncWithDeadline(semExp, locale, semanticMemory, linguisticDb,
+                JiniOutputter(), false, 0))
+
+            val outputter = JiniOutputter()
+            assertEquals(callOperators(operators, semExp, locale, semanticMemory, linguisticDb, JiniOutputter()),
+                callOperatorsAsyncWithDeadline(operators, semExp, locale, semanticMemory, linguisticDb,
+                    outputter, 10_000))
+            assertEquals("onResource(mission, avance-id, {distance=0,3 mètre})",
+                outputter.rootExecutionData.toStr())
+            assertEquals("", lateOutputter.rootExecutionData.toStr())
+        }
+
+        semExp.dispose()
+        textProcessingContext.dispose()
+        semanticMemory.dispose()
+        linguisticDb.dispose()
+    }
+}
@@ -11,6 +11,7 @@ import org.junit.Assert.*
 import org.junit.Test
 import java.io.BufferedReader
 import java.io.ByteArrayOutputStream
+import java.io.File
 import java.io.IOException
 import java.io.InputStream
 import java.io.InputStreamReader
@@ -70,6 +71,201 @@ class OnsemTests {
         )
     }
 
+    @Test
+    fun categorizeABatchOfTexts() {
+        val targetContext: Context = InstrumentationRegistry.getInstrumentation().targetContext
+        val linguisticDb = LinguisticDatabase(targetContext.assets)
+        val semanticMemory = SemanticMemory()
+        val textProcessingContext = TextProcessingContext(toRobot = true, locale)
+        val semExps = textsToSemanticExpressions(
+            arrayOf("qui es-tu", "saute", "Je suis ton ami", "Un robot"), textProcessingContext,
+            SemanticSourceEnum.UNKNOWN, semanticMemory, linguisticDb
+        )
+        assertEquals(
+            listOf(
+                ExpressionCategory.QUESTION, ExpressionCategory.COMMAND,
+                ExpressionCategory.AFFIRMATION, ExpressionCategory.NOMINALGROUP
+            ),
+            semExps.map { categorize(it) })
+        semExps.forEach { it.dispose() }
+        textProcessingContext.dispose()
+        semanticMemory.dispose()
+        linguisticDb.dispose()
+    }
+
+    @Test
+    fun loadLanguagesOnDemand() {
+        val targetContext: Context = InstrumentationRegistry.getInstrumentation().targetContext
+        val linguisticDb = LinguisticDatabase(targetContext.assets, locales = arrayOf(), loadLanguagesOnDemand = true)
+        // The french is loaded at the first parsing of a french text
+        assertEquals(ExpressionCategory.COMMAND, textToCategory("saute", linguisticDb))
+        linguisticDb.preloadLanguage(Locale.ENGLISH)
+        assertEquals(ExpressionCategory.QUESTION, textToCategory("qui es-tu", linguisticDb))
+        linguisticDb.dispose()
+
+        // The languages preloaded together are constructed at once
+        val preloadedLinguisticDb = LinguisticDatabase(targetContext.assets, locales = arrayOf(),
+            loadLanguagesOnDemand = true)
+        preloadedLinguisticDb.preloadLanguages(Locale.FRENCH, Locale.ENGLISH)
+        assertEquals(ExpressionCategory.COMMAND, textToCategory("saute", preloadedLinguisticDb))
+        assertEquals("en", getLocaleFromText("what is your name", preloadedLinguisticDb))
+        preloadedLinguisticDb.dispose()
+    }
+
+    @Test
+    fun sharedLinguisticDatabase() {
+        val targetContext: Context = InstrumentationRegistry.getInstrumentation().targetContext
+        val linguisticDb1 = LinguisticDatabase(targetContext.assets)
+        val linguisticDb2 = LinguisticDatabase(targetContext.assets)
+        // The native database stays alive while one of the java objects uses it
+        linguisticDb1.dispose()
+        assertEquals(ExpressionCategory.COMMAND, textToCategory("saute", linguisticDb2))
+        linguisticDb2.dispose()
+    }
+
+    @Test
+    fun parseCache() {
+        val targetContext: Context = InstrumentationRegistry.getInstrumentation().targetContext
+        val linguisticDb = LinguisticDatabase(targetContext.assets)
+        linguisticDb.useParseCache()
+        assertEquals(ExpressionCategory.COMMAND, textToCategory("saute", linguisticDb))
+        // The spaces are normalized and an equivalent text processing context has the same key
+        assertEquals(ExpressionCategory.COMMAND, textToCategory(" saute  ", linguisticDb))
+        assertEquals(ParseCacheStatistics(nbOfHits = 1, nbOfMisses = 1), linguisticDb.getParseCacheStatistics())
+        // The cache is not used by another object that shares the same native database
+        val otherLinguisticDb = LinguisticDatabase(targetContext.assets)
+        assertEquals(ExpressionCategory.COMMAND, textToCategory("saute", otherLinguisticDb))
+        assertEquals(ParseCacheStatistics(nbOfHits = 0, nbOfMisses = 0), otherLinguisticDb.getParseCacheStatistics())
+        assertEquals(ParseCacheStatistics(nbOfHits = 1, nbOfMisses = 1), linguisticDb.getParseCacheStatistics())
+        otherLinguisticDb.dispose()
+        linguisticDb.useParseCache(0)
+        linguisticDb.dispose()
+    }
+
+    @Test
+    fun localesFromTexts() {
+        val targetContext: Context = InstrumentationRegistry.getInstrumentation().targetContext
+        val linguisticDb = LinguisticDatabase(targetContext.assets)
+        assertEquals("fr", getLocaleFromText("Je suis content de vous voir", linguisticDb))
+        assertEquals("en", getLocaleFromText("what is your name", linguisticDb))
+        assertEquals("ja", getLocaleFromText("こんにちは", linguisticDb))
+        assertEquals("un", getLocaleFromText("42 !", linguisticDb))
+        // The batch gives the same locales as the calls text by text
+        val texts = arrayOf("saute", "Je suis content de vous voir", "what is your name", "こんにちは", "jump")
+        assertArrayEquals(texts.map { getLocaleFromText(it, linguisticDb) }.toTypedArray(),
+            getLocalesFromTexts(texts, linguisticDb))
+        linguisticDb.dispose()
+    }
+
+    @Test
+    fun localesOfShortAndMixedTexts() {
+        val targetContext: Context = InstrumentationRegistry.getInstrumentation().targetContext
+        // Only the loaded languages are returned, even for the texts whose script or trigrams are obvious,
+        // if the languages are not loaded on demand
+        val frenchLinguisticDb = LinguisticDatabase(targetContext.assets, locales = arrayOf(Locale.FRENCH))
+        assertEquals("fr", getLocaleFromText("Je suis content de vous voir", frenchLinguisticDb))
+        for (text in listOf("what is your name", "こんにちは", "le the", "ok"))
+            assertTrue(text, getLocaleFromText(text, frenchLinguisticDb) in setOf("fr", "un"))
+        frenchLinguisticDb.dispose()
+
+        // The languages that can be loaded on demand are identified before their loading
+        val lazyLinguisticDb = LinguisticDatabase(targetContext.assets, locales = arrayOf(),
+            loadLanguagesOnDemand = true)
+        assertEquals("fr", getLocaleFromText("Je suis content de vous voir", lazyLinguisticDb))
+        assertEquals("en", getLocaleFromText("what is your name", lazyLinguisticDb))
+        assertEquals("ja", getLocaleFromText("こんにちは", lazyLinguisticDb))
+        lazyLinguisticDb.dispose()
+
+        // The English trigrams of "the" do not settle a text of two words, it is left to the dictionaries
+        val englishLinguisticDb = LinguisticDatabase(targetContext.assets, locales = arrayOf(Locale.ENGLISH))
+        val texts = arrayOf("le the", "ok", "Je suis content de vous voir")
+        for (text in texts)
+            assertTrue(text, getLocaleFromText(text, englishLinguisticDb) in setOf("en", "un"))
+        assertArrayEquals(texts.map { getLocaleFromText(it, englishLinguisticDb) }.toTypedArray(),
+            getLocalesFromTexts(texts, englishLinguisticDb))
+        englishLinguisticDb.dispose()
+    }
+
+    @Test
+    fun topRecommendations() {
+        val targetContext: Context = InstrumentationRegistry.getInstrumentation().targetContext
+        val linguisticDb = LinguisticDatabase(targetContext.assets)
+        val semanticMemory = SemanticMemory()
+        val locale = Locale.FRENCH
+        val recommendationsFinder = RecommendationsFinder(linguisticDb)
+        recommendationsFinder.addRecommendation("Je veux danser", "dance", locale, linguisticDb)
+        recommendationsFinder.addRecommendation("Je veux chanter", "sing", locale, linguisticDb)
+        recommendationsFinder.addRecommendation("Je veux manger", "eat", locale, linguisticDb)
+        recommendationsFinder.addRecommendation("Tu veux dormir", "sleep", locale, linguisticDb)
+        recommendationsFinder.addRecommendation("Il fait beau", "weather", locale, linguisticDb)
+        val textProcessingContext = TextProcessingContext(toRobot = true, locale)
+        val semExp = textToSemanticExpression("je veux danser", textProcessingContext, SemanticSourceEnum.UNKNOWN,
+            semanticMemory, linguisticDb)
+
+        val allRecommendations = recommendationsFinder.getTopRecommendations(semExp, linguisticDb, 10)
+        assertEquals("dance", allRecommendations.first().id)
+        assertEquals(allRecommendations.sortedWith(compareBy({ -it.score }, { it.id })), allRecommendations.toList())
+        // The top K is the beginning of the full list, and the previous function returns 3 recommendations
+        assertArrayEquals(allRecommendations.take(1).toTypedArray(),
+            recommendationsFinder.getTopRecommendations(semExp, linguisticDb, 1))
+        assertArrayEquals(allRecommendations.take(3).map { it.id }.toTypedArray(),
+            recommendationsFinder.getRecommendations(semExp, linguisticDb))
+        val minScore = allRecommendations.first().score
+        assertTrue(recommendationsFinder.getTopRecommendations(semExp, linguisticDb, 10, minScore).all { it.score >= minScore })
+        assertEquals("dance", recommendationsFinder.getTopRecommendations(semExp, linguisticDb, useIndex = true).first().id)
+
+        semExp.dispose()
+        textProcessingContext.dispose()
+        recommendationsFinder.dispose()
+        semanticMemory.dispose()
+        linguisticDb.dispose()
+    }
+
+    @Test
+    fun recommendationsBulkAndFile() {
+        val targetContext: Context = InstrumentationRegistry.getInstrumentation().targetContext
+        val linguisticDb = LinguisticDatabase(targetContext.assets)
+        val semanticMemory = SemanticMemory()
+        val texts = arrayOf("Je veux danser", "Je veux chanter", "Je veux manger", "Tu veux dormir", "Il fait beau")
+        val ids = arrayOf("dance", "sing", "eat", "sleep", "weather")
+        val recommendationsFinder = RecommendationsFinder(linguisticDb)
+        for (i in texts.indices)
+            recommendationsFinder.addRecommendation(texts[i], ids[i], locale, linguisticDb)
+        val bulkRecommendationsFinder = RecommendationsFinder(linguisticDb)
+        bulkRecommendationsFinder.addRecommendationsBulk(texts, ids, locale, linguisticDb)
+        val file = File(targetContext.cacheDir, "recommendations.bin")
+        bulkRecommendationsFinder.save(file)
+        val loadedRecommendationsFinder = loadRecommendationsFinder(file, linguisticDb)
+        val textProcessingContext = TextProcessingContext(toRobot = true, locale)
+
+        // The three finders give the same recommendations
+        for (text in listOf("je veux danser", "tu veux dormir", "il fait beau")) {
+            val semExp = textToSemanticExpression(text, textProcessingContext, SemanticSourceEnum.UNKNOWN,
+                semanticMemory, linguisticDb)
+            for (useIndex in listOf(false, true)) {
+                val expected = recommendationsFinder.getTopRecommendations(semExp, linguisticDb, 10, useIndex = useIndex)
+                assertArrayEquals(expected,
+                    bulkRecommendationsFinder.getTopRecommendations(semExp, linguisticDb, 10, useIndex = useIndex))
+                assertArrayEquals(expected,
+                    loadedRecommendationsFinder.getTopRecommendations(semExp, linguisticDb, 10, useIndex = useIndex))
+            }
+            semExp.dispose()
+        }
+        try {
+            recommendationsFinder.addRecommendationsBulk(texts, arrayOf("dance"), locale, linguisticDb)
+            fail("the number of ids is different from the number of texts")
+        } catch (e: RuntimeException) {
+        }
+
+        file.delete()
+        textProcessingContext.dispose()
+        loadedRecommendationsFinder.dispose()
+        bulkRecommendationsFinder.dispose()
+        recommendationsFinder.dispose()
+        semanticMemory.dispose()
+        linguisticDb.dispose()
+    }
+
     @Test
     fun notKnowing() {
         val targetContext: Context = InstrumentationRegistry.getInstrumentation().targetContext
@@ -81,6 +277,199 @@ class OnsemTests {
     }
 
 
+    @Test
+    fun staleIdAfterManyReusesOfItsSlot() {
+        val targetContext: Context = InstrumentationRegistry.getInstrumentation().targetContext
+        val linguisticDb = LinguisticDatabase(targetContext.assets)
+        val semanticMemory = SemanticMemory()
+        val staleTextProcessingContext = TextProcessingContext(toRobot = true, locale)
+        staleTextProcessingContext.dispose()
+
+        // The 20 low bits of an id are the slot index, a slot has 2048 generations
+        val slotIndexMask = (1 shl 20) - 1
+        val staleSlotIndex = staleTextProcessingContext.id and slotIndexMask
+        var nbOfReuses = 0
+        var nbOfCreations = 0
+        while (nbOfReuses <= 2048 && nbOfCreations < 2048 * 64) {
+            val textProcessingContext = TextProcessingContext(toRobot = true, locale)
+            ++nbOfCreations
+            if ((textProcessingContext.id and slotIndexMask) == staleSlotIndex) {
+                ++nbOfReuses
+                try {
+                    textToSemanticExpression("saute", staleTextProcessingContext, SemanticSourceEnum.UNKNOWN,
+                        semanticMemory, linguisticDb).dispose()
+                    fail("the stale id points to the text processing context number $nbOfReuses of its slot")
+                } catch (e: RuntimeException) {
+                }
+            }
+            textProcessingContext.dispose()
+        }
+        try {
+            textToSemanticExpression("saute", staleTextProcessingContext, SemanticSourceEnum.UNKNOWN,
+                semanticMemory, linguisticDb).dispose()
+            fail("the stale id is still valid")
+        } catch (e: RuntimeException) {
+        }
+
+        semanticMemory.dispose()
+        linguisticDb.dispose()
+    }
+
+
+    @Test
+    fun consumeASemanticExpression() {
+        val targetContext: Context = InstrumentationRegistry.getInstrumentation().targetContext
+        val linguisticDb = LinguisticDatabase(targetContext.assets)
+        val semanticMemory = SemanticMemory()
+        val textProcessingContext = TextProcessingContext(toRobot = true, locale)
+        val semExp = textToSemanticExpression(
+            "saute", textProcessingContext, SemanticSourceEnum.UNKNOWN,
+            semanticMemory, linguisticDb
+        )
+        val notKnowingSemExp = notKnowing(semExp, semanticMemory, linguisticDb)!!
+        assertEquals(
+            "Je ne sais pas sauter.",
+            semanticExpressionToTextAndConsume(notKnowingSemExp, locale, semanticMemory, linguisticDb)
+        )
+        assertTrue(notKnowingSemExp.isDisposed)
+        semExp.dispose()
+        textProcessingContext.dispose()
+        semanticMemory.dispose()
+        linguisticDb.dispose()
+    }
+
+    private fun answerText(text: String, semanticMemory: SemanticMemory, linguisticDb: LinguisticDatabase): String {
+        val textProcessingContext = TextProcessingContext(toRobot = true, locale)
+        val semExp = textToSemanticExpression(
+            text, textProcessingContext, SemanticSourceEnum.UNKNOWN,
+            semanticMemory, linguisticDb
+        )
+        val answerSemExp = answer(semExp, semanticMemory, linguisticDb) ?: return ""
+        return semanticExpressionToTextAndConsume(answerSemExp, locale, semanticMemory, linguisticDb)
+    }
+
+    @Test
+    fun memorySnapshot() {
+        val targetContext: Context = InstrumentationRegistry.getInstrumentation().targetContext
+        val linguisticDb = LinguisticDatabase(targetContext.assets)
+        val semanticMemory = SemanticMemory()
+        semanticMemory.setCurrentUserId("user-1")
+        val textProcessingContext = TextProcessingContext(toRobot = true, locale)
+        val semExp = textToSemanticExpression(
+            "Paul est mon ami", textProcessingContext, SemanticSourceEnum.UNKNOWN,
+            semanticMemory, linguisticDb
+        )
+        informAxiomAndConsume(semExp, semanticMemory, linguisticDb)
+        val expectedAnswer = answerText("qui est Paul", semanticMemory, linguisticDb)
+        assertNotEquals("", expectedAnswer)
+
+        val snapshotFile = File(targetContext.cacheDir, "memory.snapshot")
+        saveMemorySnapshot(semanticMemory, snapshotFile)
+        val loadedMemory = loadMemorySnapshot(snapshotFile, linguisticDb)
+        assertEquals("user-1", loadedMemory.getCurrentUserId())
+        assertEquals(expectedAnswer, answerText("qui est Paul", loadedMemory, linguisticDb))
+
+        snapshotFile.delete()
+        loadedMemory.dispose()
+        textProcessingContext.dispose()
+        semanticMemory.dispose()
+        linguisticDb.dispose()
+    }
+
+    @Test
+    fun memoryJournal() {
+        val targetContext: Context = InstrumentationRegistry.getInstrumentation().targetContext
+        val linguisticDb = LinguisticDatabase(targetContext.assets)
+        val snapshotFile = File(targetContext.cacheDir, "journaled.snapshot")
+        val journalFile = File(targetContext.cacheDir, "journaled.journal")
+        snapshotFile.delete()
+        journalFile.delete()
+
+        var semanticMemory = openMemoryWithJournal(snapshotFile, journalFile, linguisticDb)
+        semanticMemory.setCurrentUserId("user-1")
+        val textProcessingContext = TextProcessingContext(toRobot = true, locale)
+        val semExp = textToSemanticExpression(
+            "Paul est mon ami", textProcessingContext, SemanticSourceEnum.UNKNOWN,
+            semanticMemory, linguisticDb
+        )
+        informAxiomAndConsume(semExp, semanticMemory, linguisticDb)
+        val expectedAnswer = answerText("qui est Paul", semanticMemory, linguisticDb)
+        // The disposal writes the end of the journal
+        semanticMemory.dispose()
+
+        // The memory is restored by replaying the journal
+        semanticMemory = openMemoryWithJournal(snapshotFile, journalFile, linguisticDb)
+        assertEquals("user-1", semanticMemory.getCurrentUserId())
+        assertEquals(expectedAnswer, answerText("qui est Paul", semanticMemory, linguisticDb))
+
+        semanticMemory.dispose()
+        snapshotFile.delete()
+        journalFile.delete()
+        textProcessingContext.dispose()
+        linguisticDb.dispose()
+    }
+
+    @Test
+    fun disposeAJournaledMemoryDuringACompaction() {
+        val targetContext: Context = InstrumentationRegistry.getInstrumentation().targetContext
+        val linguisticDb = LinguisticDatabase(targetContext.assets)
+        val snapshotFile = File(targetContext.cacheDir, "disposed.snapshot")
+        val journalFile = File(targetContext.cacheDir, "disposed.journal")
+        snapshotFile.delete()
+        journalFile.delete()
+        val textProcessingContext = TextProcessingContext(toRobot = true, locale)
+        val names = listOf("Paul", "Marie", "Jean", "Luc", "Anne")
+
+        // With a compaction interval of 1ms, each memory is disposed while its compaction is pending or running
+        for (i in 0 until 20) {
+            val semanticMemory = openMemoryWithJournal(snapshotFile, journalFile, linguisticDb, compactionIntervalMs = 1)
+            val semExp = textToSemanticExpression(
+                "${names[i % names.size]} est mon ami", textProcessingContext, SemanticSourceEnum.UNKNOWN,
+                semanticMemory, linguisticDb
+            )
+            informAxiomAndConsume(semExp, semanticMemory, linguisticDb)
+            if (i % 2 == 1)
+                Thread.sleep(1)
+            semanticMemory.dispose()
+        }
+
+        // Nothing was lost by the disposals
+        val semanticMemory = openMemoryWithJournal(snapshotFile, journalFile, linguisticDb)
+        for (name in names)
+            assertNotEquals("", answerText("qui est $name", semanticMemory, linguisticDb))
+
+        semanticMemory.dispose()
+        snapshotFile.delete()
+        journalFile.delete()
+        textProcessingContext.dispose()
+        linguisticDb.dispose()
+    }
+
+    @Test
+    fun addTriggersFromJson() {
+        val targetContext: Context = InstrumentationRegistry.getInstrumentation().targetContext
+        val linguisticDb = LinguisticDatabase(targetContext.assets)
+        val semanticMemory = SemanticMemory()
+        val json = """[
+            {"trigger": "Avance", "resourceType": "mission", "resourceId": "avance-id",
+             "parameters": {"distance": ["combien de mètres"]}},
+            {"trigger": "Bonjour", "answer": "Salut"}
+        ]"""
+        addTriggers(readTriggerSpecs(json.byteInputStream()), locale, semanticMemory, linguisticDb)
+
+        val textProcessingContext = TextProcessingContext(toRobot = true, locale)
+        val semExp = textToSemanticExpression("Avance de 30 centimètres", textProcessingContext,
+            SemanticSourceEnum.UNKNOWN, semanticMemory, linguisticDb)
+        val jiniOutputter = JiniOutputter()
+        reactFromTrigger(semExp, locale, semanticMemory, linguisticDb, jiniOutputter)
+        assertEquals("onResource(mission, avance-id, {distance=0,3 mètre})", jiniOutputter.rootExecutionData.toStr())
+
+        semExp.dispose()
+        textProcessingContext.dispose()
+        semanticMemory.dispose()
+        linguisticDb.dispose()
+    }
+
     private fun outputterToStr(
         executionData: ExecutionData
     ): String {
@@ -4,6 +4,7 @@ import android.content.Context
 import androidx.test.platform.app.InstrumentationRegistry
 import org.junit.Assert.*
 import org.junit.Test
+import java.io.File
 import java.util.*
 
 class TriggersTests {
@@ -61,4 +62,65 @@ class TriggersTests {
             reactFromTriggerStr(locale, "Dime quien eres", semanticMemory, linguisticDb))
     }
 
+    @Test
+    fun triggerCache() {
+        val targetContext: Context = InstrumentationRegistry.getInstrumentation().targetContext
+        val locale = Locale.ENGLISH
+        val cacheFile = File(targetContext.cacheDir, "triggers.cache")
+        cacheFile.delete()
+
+        // The first run parses the trigger and writes it in the cache
+        var linguisticDb = LinguisticDatabase(targetContext.assets)
+        linguisticDb.useTriggerCache(cacheFile)
+        var semanticMemory = SemanticMemory()
+        val parameters = HashMap<String, Array<String>>();
+        parameters["distance"] = arrayOf("combien de mètres")
+        addTriggerToAResource("who are you", "mission", "reaction-id", mapOf(), locale, semanticMemory, linguisticDb)
+        addTriggerToAResource("Avance", "mission", "avance-id", parameters, Locale.FRENCH, semanticMemory, linguisticDb)
+        // The cache is not used by another object that shares the same native database
+        val otherLinguisticDb = LinguisticDatabase(targetContext.assets)
+        otherLinguisticDb.saveTriggerCache()
+        assertFalse(cacheFile.exists())
+        otherLinguisticDb.dispose()
+        linguisticDb.saveTriggerCache()
+        assertTrue(cacheFile.exists())
+        semanticMemory.dispose()
+        linguisticDb.dispose()
+
+        // The second run reads the trigger from the cache
+        linguisticDb = LinguisticDatabase(targetContext.assets)
+        linguisticDb.useTriggerCache(cacheFile)
+        semanticMemory = SemanticMemory()
+        addTriggerToAResource("who are you", "mission", "reaction-id", mapOf(), locale, semanticMemory, linguisticDb)
+        addTriggerToAResource("Avance", "mission", "avance-id", parameters, Locale.FRENCH, semanticMemory, linguisticDb)
+        assertEquals("onResource(mission, reaction-id, {})",
+            reactFromTriggerStr(locale, "tell me who you are", semanticMemory, linguisticDb))
+        // The questions of the parameters are also read from the cache
+        assertEquals("onResource(mission, avance-id, {distance=0,3 mètre})",
+            reactFromTriggerStr(Locale.FRENCH, "Avance de 30 centimètres", semanticMemory, linguisticDb))
+        semanticMemory.dispose()
+        linguisticDb.dispose()
+        cacheFile.delete()
+    }
+
+    @Test
+    fun synthesisCache() {
+        val targetContext: Context = InstrumentationRegistry.getInstrumentation().targetContext
+        val semanticMemory = SemanticMemory()
+        semanticMemory.useSynthesisCache()
+        val linguisticDb = LinguisticDatabase(targetContext.assets)
+        val locale = Locale.FRENCH
+
+        val parameters = HashMap<String, Array<String>>();
+        parameters["distance"] = arrayOf("combien de mètres")
+        addTriggerToAResource("Avance", "mission", "avance-id", parameters, locale, semanticMemory, linguisticDb)
+
+        // The second reaction to the same input comes from the cache, the parameters of another input do not
+        for (i in 0 until 2) {
+            assertEquals("onResource(mission, avance-id, {distance=0,3 mètre})",
+                reactFromTriggerStr(locale, "Avance de 30 centimètres", semanticMemory, linguisticDb))
+            assertEquals("onResource(mission, avance-id, {distance=0,2 mètre})",
+                reactFromTriggerStr(locale, "Avance de 20 centimètres", semanticMemory, linguisticDb))
+        }
+    }
 }
\ No newline at end of file
@@ -0,0 +1,159 @@
+#include "assetsources.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <stdexcept>
+#include "keytoassetstreams.hpp"
+
+
+namespace {
+
+    /// Read one byte per page, so that the page faults happen now instead of during the parsing.
+    void _loadInMemory(const void *pData, std::size_t pSize) {
+        static const auto pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        auto data = static_cast<const volatile char *>(pData);
+        for (std::size_t i = 0; i < pSize; i += pageSize)
+            (void) data[i];
+    }
+
+
+    /**
+     * Streambuf to read a memory area that is already fully loaded or mapped.
+     */
+    class MemoryStreambuf : public std::streambuf {
+    public:
+        void setMemory(const void *pData, std::size_t pSize) {
+            _loadInMemory(pData, pSize);
+            // The get area is never written, the const_cast is only needed by the streambuf API
+            auto begin = const_cast<char *>(static_cast<const char *>(pData));
+            setg(begin, begin, begin + pSize);
+        }
+
+    protected:
+        pos_type seekoff(off_type pOff, std::ios_base::seekdir pDir,
+                         std::ios_base::openmode pWhich) override {
+            if ((pWhich & std::ios_base::in) == 0)
+                return pos_type(off_type(-1));
+            off_type newPos = pOff;
+            if (pDir == std::ios_base::cur)
+                newPos += gptr() - eback();
+            else if (pDir == std::ios_base::end)
+                newPos += egptr() - eback();
+            if (newPos < 0 || newPos > egptr() - eback())
+                return pos_type(off_type(-1));
+            setg(eback(), eback() + newPos, egptr());
+            return pos_type(newPos);
+        }
+
+        pos_type seekpos(pos_type pPos, std::ios_base::openmode pWhich) override {
+            return seekoff(off_type(pPos), std::ios_base::beg, pWhich);
+        }
+    };
+
+
+    class MappedAssetStreambuf : public MemoryStreambuf {
+    public:
+        explicit MappedAssetStreambuf(AAsset *pAsset)
+                : _asset(pAsset) {
+            setMemory(AAsset_getBuffer(_asset), static_cast<std::size_t>(AAsset_getLength64(_asset)));
+        }
+
+        ~MappedAssetStreambuf() override {
+            AAsset_close(_asset);
+        }
+
+    private:
+        AAsset *_asset;
+    };
+
+
+    class MappedFileStreambuf : public MemoryStreambuf {
+    public:
+        explicit MappedFileStreambuf(const std::string &pFilename)
+                : _data(nullptr),
+                  _size(0) {
+            int fd = ::open(pFilename.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+                throw std::runtime_error("file not found: " + pFilename);
+            struct stat fileStat{};
+            if (fstat(fd, &fileStat) != 0) {
+                ::close(fd);
+                throw std::runtime_error("failed to get the size of the file: " + pFilename);
+            }
+            _size = static_cast<std::size_t>(fileStat.st_size);
+            if (_size > 0) {
+                _data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (_data == MAP_FAILED) {
+                    ::close(fd);
+                    throw std::runtime_error("failed to map the file: " + pFilename);
+                }
+                madvise(_data, _size, MADV_WILLNEED);
+            }
+            // The mapping stays valid after the close of the file descriptor
+            ::close(fd);
+            setMemory(_data, _size);
+        }
+
+        ~MappedFileStreambuf() override {
+            if (_size > 0)
+                munmap(_data, _size);
+        }
+
+    private:
+        void *_data;
+        std::size_t _size;
+    };
+
+
+    /**
+     * Istream that owns its streambuf.
+     */
+    class StreambufOwnerIstream : public std::istream {
+    public:
+        explicit StreambufOwnerIstream(std::unique_ptr<std::streambuf> pStreambuf)
+                : std::istream(pStreambuf.get()),
+                  _streambuf(std::move(pStreambuf)) {
+        }
+
+    private:
+        std::unique_ptr<std::streambuf> _streambuf;
+    };
+
+
+    AAsset *_openAsset(AAssetManager *pAssetManager, const std::string &pFilename, int pMode) {
+        AAsset *res = AAssetManager_open(pAssetManager, pFilename.c_str(), pMode);
+        if (res == nullptr)
+            throw std::runtime_error("asset not found: " + pFilename);
+        return res;
+    }
+}
+
+
+StreamingAssetSource::StreamingAssetSource(AAssetManager *pAssetManager)
+        : _assetManager(pAssetManager) {
+}
+
+std::unique_ptr<std::istream> StreamingAssetSource::open(const std::string &pFilename) const {
+    return std::make_unique<AssetIstream>(_assetManager, pFilename);
+}
+
+
+MappedAssetSource::MappedAssetSource(AAssetManager *pAssetManager)
+        : _assetManager(pAssetManager) {
+}
+
+std::unique_ptr<std::istream> MappedAssetSource::open(const std::string &pFilename) const {
+    AAsset *asset = _openAsset(_assetManager, pFilename, AASSET_MODE_BUFFER);
+    if (AAsset_getBuffer(asset) == nullptr) {
+        // The buffer can be unavailable, for example if there is not enough memory to decompress the asset
+        AAsset_close(asset);
+        return StreamingAssetSource(_assetManager).open(pFilename);
+    }
+    return std::make_unique<StreambufOwnerIstream>(std::make_unique<MappedAssetStreambuf>(asset));
+}
+
+
+std::unique_ptr<std::istream> MappedFileSource::open(const std::string &pFilename) const {
+    return std::make_unique<StreambufOwnerIstream>(std::make_unique<MappedFileStreambuf>(pFilename));
+}
\ No newline at end of file
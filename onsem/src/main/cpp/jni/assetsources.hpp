@@ -0,0 +1,62 @@
+#ifndef SEMANTIC_ANDROID_ASSETSOURCES_HPP
+#define SEMANTIC_ANDROID_ASSETSOURCES_HPP
+
+#include <istream>
+#include <memory>
+#include <string>
+#include <android/asset_manager.h>
+
+
+/**
+ * Source of the files needed to construct a linguistic database.
+ */
+class AssetSource {
+public:
+    virtual ~AssetSource() = default;
+
+    /// Open a file, throw if the file does not exist. (it can be called from several threads)
+    virtual std::unique_ptr<std::istream> open(const std::string &pFilename) const = 0;
+};
+
+
+/**
+ * Read the files of the assets chunk by chunk with AAsset_read.
+ */
+class StreamingAssetSource : public AssetSource {
+public:
+    explicit StreamingAssetSource(AAssetManager *pAssetManager);
+
+    std::unique_ptr<std::istream> open(const std::string &pFilename) const override;
+
+private:
+    AAssetManager *_assetManager;
+};
+
+
+/**
+ * Read the files of the assets directly from the memory returned by AAsset_getBuffer.
+ * For the assets that are not compressed in the apk it is a memory mapping of the apk, so there is no copy.
+ * The content is loaded in memory at the opening.
+ */
+class MappedAssetSource : public AssetSource {
+public:
+    explicit MappedAssetSource(AAssetManager *pAssetManager);
+
+    std::unique_ptr<std::istream> open(const std::string &pFilename) const override;
+
+private:
+    AAssetManager *_assetManager;
+};
+
+
+/**
+ * Read plain files mapped in memory with mmap.
+ * The content is loaded in memory at the opening.
+ */
+class MappedFileSource : public AssetSource {
+public:
+    std::unique_ptr<std::istream> open(const std::string &pFilename) const override;
+};
+
+
+#endif // SEMANTIC_ANDROID_ASSETSOURCES_HPP
@@ -0,0 +1,39 @@
+#include "groundingfeatures.hpp"
+#include <onsem/texttosemantic/dbtype/semanticexpression/groundedexpression.hpp>
+#include <onsem/texttosemantic/dbtype/semanticexpression/listexpression.hpp>
+#include <onsem/texttosemantic/dbtype/semanticgrounding/semanticagentgrounding.hpp>
+#include <onsem/texttosemantic/dbtype/semanticgrounding/semanticgenericgrounding.hpp>
+
+using namespace onsem;
+
+
+bool forEachGroundingFeature(
+        const SemanticExpression &pSemExp,
+        const std::function<void(GroundingFeatureKind, const std::string &)> &pOnFeature) {
+    const auto *grdExpPtr = pSemExp.getGrdExpPtr_SkipWrapperPtrs();
+    if (grdExpPtr != nullptr) {
+        const auto &grounding = grdExpPtr->grounding();
+        for (const auto &currConcept : grounding.concepts)
+            pOnFeature(GroundingFeatureKind::CONCEPT, currConcept.first);
+        const auto *agentGrdPtr = grounding.getAgentGroundingPtr();
+        if (agentGrdPtr != nullptr) {
+            pOnFeature(GroundingFeatureKind::AGENT, agentGrdPtr->userId);
+        } else if (grounding.concepts.empty()) {
+            const auto *genGrdPtr = grounding.getGenericGroundingPtr();
+            if (genGrdPtr != nullptr && !genGrdPtr->word.lemma.empty())
+                pOnFeature(GroundingFeatureKind::WORD, genGrdPtr->word.lemma);
+        }
+        bool res = true;
+        for (const auto &currChild : grdExpPtr->children)
+            res = forEachGroundingFeature(*currChild.second, pOnFeature) && res;
+        return res;
+    }
+    const auto *listExpPtr = pSemExp.getListExpPtr_SkipWrapperPtrs();
+    if (listExpPtr != nullptr) {
+        bool res = true;
+        for (const auto &currElt : listExpPtr->elts)
+            res = forEachGroundingFeature(*currElt, pOnFeature) && res;
+        return res;
+    }
+    return false;
+}
\ No newline at end of file
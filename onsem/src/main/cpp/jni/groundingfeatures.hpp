@@ -0,0 +1,30 @@
+#ifndef SEMANTIC_ANDROID_GROUNDINGFEATURES_HPP
+#define SEMANTIC_ANDROID_GROUNDINGFEATURES_HPP
+
+#include <functional>
+#include <string>
+
+namespace onsem {
+    struct SemanticExpression;
+}
+
+/// Kind of a feature of a grounding.
+enum class GroundingFeatureKind {
+    CONCEPT,
+    AGENT,
+    /// Lemma of a word that has no concept. (e.g. the name of a thing)
+    WORD
+};
+
+
+/**
+ * Call pOnFeature for each feature of the groundings of an expression.
+ * Only the grounded expressions and the lists are walked (through their wrappers).
+ * Return false if the expression contains another kind of expression, then its features can be incomplete.
+ */
+bool forEachGroundingFeature(
+        const onsem::SemanticExpression &pSemExp,
+        const std::function<void(GroundingFeatureKind, const std::string &)> &pOnFeature);
+
+
+#endif // SEMANTIC_ANDROID_GROUNDINGFEATURES_HPP
@@ -0,0 +1,104 @@
+#include "javabindings.hpp"
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    std::unique_ptr<const JavaBindings> _javaBindings;
+
+    jclass _findGlobalClass(JNIEnv *env, const char *pClassName) {
+        jclass localClass = env->FindClass(pClassName);
+        if (localClass == nullptr)
+            throw std::runtime_error(std::string("java class not found: ") + pClassName);
+        auto res = static_cast<jclass>(env->NewGlobalRef(localClass));
+        env->DeleteLocalRef(localClass);
+        return res;
+    }
+
+    jmethodID _getMethodId(JNIEnv *env, const char *pClassName, const char *pMethodName,
+                           const char *pSignature) {
+        jclass localClass = env->FindClass(pClassName);
+        if (localClass == nullptr)
+            throw std::runtime_error(std::string("java class not found: ") + pClassName);
+        jmethodID res = env->GetMethodID(localClass, pMethodName, pSignature);
+        env->DeleteLocalRef(localClass);
+        if (res == nullptr)
+            throw std::runtime_error(std::string("java method not found: ") + pClassName + "." + pMethodName);
+        return res;
+    }
+
+    jfieldID _getFieldId(JNIEnv *env, const char *pClassName, const char *pFieldName,
+                         const char *pSignature) {
+        jclass localClass = env->FindClass(pClassName);
+        if (localClass == nullptr)
+            throw std::runtime_error(std::string("java class not found: ") + pClassName);
+        jfieldID res = env->GetFieldID(localClass, pFieldName, pSignature);
+        env->DeleteLocalRef(localClass);
+        if (res == nullptr)
+            throw std::runtime_error(std::string("java field not found: ") + pClassName + "." + pFieldName);
+        return res;
+    }
+}
+
+
+JavaBindings::JavaBindings(JNIEnv *env)
+        : runtimeExceptionClass(_findGlobalClass(env, "java/lang/RuntimeException")),
+          stringClass(_findGlobalClass(env, "java/lang/String")),
+          enumOrdinalMethod(_getMethodId(env, "java/lang/Enum", "ordinal", "()I")),
+          localeClass(_findGlobalClass(env, "java/util/Locale")),
+          localeGetLanguageMethod(_getMethodId(env, "java/util/Locale", "getLanguage", "()Ljava/lang/String;")),
+          hashMapClass(_findGlobalClass(env, "java/util/HashMap")),
+          hashMapConstructor(_getMethodId(env, "java/util/HashMap", "<init>", "()V")),
+          hashMapPutMethod(_getMethodId(env, "java/util/HashMap", "put",
+                                        "(Ljava/lang/Object;Ljava/lang/Object;)Ljava/lang/Object;")),
+          mapEntrySetMethod(_getMethodId(env, "java/util/Map", "entrySet", "()Ljava/util/Set;")),
+          setIteratorMethod(_getMethodId(env, "java/util/Set", "iterator", "()Ljava/util/Iterator;")),
+          iteratorHasNextMethod(_getMethodId(env, "java/util/Iterator", "hasNext", "()Z")),
+          iteratorNextMethod(_getMethodId(env, "java/util/Iterator", "next", "()Ljava/lang/Object;")),
+          mapEntryGetKeyMethod(_getMethodId(env, "java/util/Map$Entry", "getKey", "()Ljava/lang/Object;")),
+          mapEntryGetValueMethod(_getMethodId(env, "java/util/Map$Entry", "getValue", "()Ljava/lang/Object;")),
+          disposableWithIdIdField(_getFieldId(env, "com/onsem/DisposableWithId", "id", "I")),
+          semanticExpressionClass(_findGlobalClass(env, "com/onsem/SemanticExpression")),
+          semanticExpressionConstructor(_getMethodId(env, "com/onsem/SemanticExpression", "<init>", "(I)V")),
+          expressionWithLinksClass(_findGlobalClass(env, "com/onsem/ExpressionWithLinks")),
+          expressionWithLinksConstructor(_getMethodId(env, "com/onsem/ExpressionWithLinks", "<init>", "(I)V")),
+          recommendationClass(_findGlobalClass(env, "com/onsem/Recommendation")),
+          recommendationConstructor(_getMethodId(env, "com/onsem/Recommendation", "<init>",
+                                                 "(Ljava/lang/String;I)V")),
+          jiniOutputterDecodeExecutionEventsMethod(_getMethodId(env, "com/onsem/JiniOutputter", "decodeExecutionEvents",
+                                                                "(Ljava/nio/ByteBuffer;)V")),
+          nativeCallbackOnSuccessMethod(_getMethodId(env, "com/onsem/NativeCallback", "onSuccess",
+                                                     "(Ljava/lang/Object;)V")),
+          nativeCallbackOnFailureMethod(_getMethodId(env, "com/onsem/NativeCallback", "onFailure",
+                                                     "(Ljava/lang/Throwable;)V")),
+          nativeCallbackIsCancelledField(_getFieldId(env, "com/onsem/NativeCallback", "isCancelled", "Z")) {
+}
+
+
+JavaGlobalRef::JavaGlobalRef(JNIEnv *env, jobject pObject)
+        : _javaVM(nullptr),
+          _object(env->NewGlobalRef(pObject)) {
+    env->GetJavaVM(&_javaVM);
+}
+
+JavaGlobalRef::~JavaGlobalRef() {
+    JNIEnv *env = nullptr;
+    if (_javaVM->GetEnv(reinterpret_cast<void **>(&env), JNI_VERSION_1_6) == JNI_OK) {
+        env->DeleteGlobalRef(_object);
+        return;
+    }
+    // The current thread is not a java thread
+    if (_javaVM->AttachCurrentThread(&env, nullptr) == JNI_OK) {
+        env->DeleteGlobalRef(_object);
+        _javaVM->DetachCurrentThread();
+    }
+}
+
+
+void initJavaBindings(JNIEnv *env) {
+    _javaBindings = std::make_unique<const JavaBindings>(env);
+}
+
+const JavaBindings &getJavaBindings() {
+    return *_javaBindings;
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#ifndef SEMANTIC_ANDROID_JAVABINDINGS_HPP
+#define SEMANTIC_ANDROID_JAVABINDINGS_HPP
+
+#include <jni.h>
+
+
+/**
+ * Java classes, methods and fields used by the JNI functions.
+ * They are resolved only once in JNI_OnLoad and the classes are kept as global references,
+ * so the JNI functions do not have to call FindClass/GetMethodID anymore.
+ */
+struct JavaBindings {
+    explicit JavaBindings(JNIEnv *env);
+
+    // Java classes
+    jclass runtimeExceptionClass;
+    jclass stringClass;
+    jmethodID enumOrdinalMethod;
+    jclass localeClass;
+    jmethodID localeGetLanguageMethod;
+    jclass hashMapClass;
+    jmethodID hashMapConstructor;
+    jmethodID hashMapPutMethod;
+    jmethodID mapEntrySetMethod;
+    jmethodID setIteratorMethod;
+    jmethodID iteratorHasNextMethod;
+    jmethodID iteratorNextMethod;
+    jmethodID mapEntryGetKeyMethod;
+    jmethodID mapEntryGetValueMethod;
+
+    // Onsem classes
+    jfieldID disposableWithIdIdField;
+    jclass semanticExpressionClass;
+    jmethodID semanticExpressionConstructor;
+    jclass expressionWithLinksClass;
+    jmethodID expressionWithLinksConstructor;
+    jclass recommendationClass;
+    jmethodID recommendationConstructor;
+    jmethodID jiniOutputterDecodeExecutionEventsMethod;
+    jmethodID nativeCallbackOnSuccessMethod;
+    jmethodID nativeCallbackOnFailureMethod;
+    jfieldID nativeCallbackIsCancelledField;
+};
+
+/**
+ * Global reference to a java object, it can be released from any thread.
+ */
+class JavaGlobalRef {
+public:
+    JavaGlobalRef(JNIEnv *env, jobject pObject);
+    ~JavaGlobalRef();
+    JavaGlobalRef(const JavaGlobalRef &) = delete;
+    JavaGlobalRef &operator=(const JavaGlobalRef &) = delete;
+
+    jobject get() const { return _object; }
+
+private:
+    JavaVM *_javaVM;
+    jobject _object;
+};
+
+
+/// Called only once, in JNI_OnLoad.
+void initJavaBindings(JNIEnv *env);
+
+const JavaBindings &getJavaBindings();
+
+
+#endif // SEMANTIC_ANDROID_JAVABINDINGS_HPP
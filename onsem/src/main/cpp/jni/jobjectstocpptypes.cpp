@@ -1,5 +1,6 @@
 #include "jobjectstocpptypes.hpp"
 #include "semanticenumsindexes.hpp"
+#include "javabindings.hpp"
 #include <list>
 #include <sstream>
 
@@ -22,9 +23,7 @@ namespace {
             const std::string &enumClassName,
             const std::vector<ENUM_TYPE> &javaOrdinalToCpp) {
         // Get the ordinal
-        jclass enumClass = env->FindClass(enumClassName.c_str());
-        jmethodID ordinalFun = env->GetMethodID(enumClass, "ordinal", "()I");
-        int ordinal = env->CallIntMethod(jobj, ordinalFun);
+        int ordinal = env->CallIntMethod(jobj, getJavaBindings().enumOrdinalMethod);
         // Report if the ordinal is not valid
         if (ordinal < 0 || ordinal >= javaOrdinalToCpp.size()) {
             std::stringstream ss;
@@ -86,9 +85,8 @@ namespace {
 
 
 SemanticLanguageEnum toLanguage(JNIEnv *env, jobject locale) {
-    jclass localeClass = env->FindClass("java/util/Locale");
-    jmethodID getLanguageFun = env->GetMethodID(localeClass, "getLanguage", "()Ljava/lang/String;");
-    auto languageJStr = reinterpret_cast<jstring>(env->CallObjectMethod(locale, getLanguageFun));
+    auto languageJStr = reinterpret_cast<jstring>(
+            env->CallObjectMethod(locale, getJavaBindings().localeGetLanguageMethod));
     const std::string languageStr = toString(env, languageJStr);
     env->DeleteLocalRef(languageJStr);
     if (languageStr == "fr")
@@ -140,9 +138,8 @@ std::string toString(JNIEnv *env, jstring inputString) {
 
 
 jint toDisposableWithIdId(JNIEnv *env, jobject object) {
-    jclass semanticMemoryClass = env->FindClass("com/onsem/DisposableWithId");
-    jmethodID getIdFun = env->GetMethodID(semanticMemoryClass, "getId", "()I");
-    return env->CallIntMethod(object, getIdFun);
+    // Direct read of the field, it is cheaper than a call to the getter
+    return env->GetIntField(object, getJavaBindings().disposableWithIdIdField);
 }
 
 
@@ -150,12 +147,15 @@ jint toDisposableWithIdId(JNIEnv *env, jobject object) {
 jobjectArray stlStringVectorToJavaArray(JNIEnv *env, const std::vector<std::string>& stdVector) {
     jobjectArray result;
     result = (jobjectArray)env->NewObjectArray(stdVector.size(),
-                                               env->FindClass("java/lang/String"),
-                                               env->NewStringUTF(""));
+                                               getJavaBindings().stringClass,
+                                               nullptr);
 
     jsize arrayElt = 0;
-    for (const auto& currElt : stdVector)
-        env->SetObjectArrayElement(result, arrayElt++, env->NewStringUTF(currElt.c_str()));
+    for (const auto& currElt : stdVector) {
+        jstring eltJava = env->NewStringUTF(currElt.c_str());
+        env->SetObjectArrayElement(result, arrayElt++, eltJava);
+        env->DeleteLocalRef(eltJava);
+    }
     return result;
 }
 
@@ -173,13 +173,9 @@ std::vector<std::string> javaArrayToStlStringVector(JNIEnv *env, jobjectArray jS
 
 
 jobject stlStringStringMapToJavaHashMap(JNIEnv *env, const std::map<std::string, std::string>& map) {
-    jclass mapClass = env->FindClass("java/util/HashMap");
-    if(mapClass == NULL)
-        return NULL;
-
-    jmethodID init = env->GetMethodID(mapClass, "<init>", "()V");
-    jobject hashMap = env->NewObject(mapClass, init);
-    jmethodID put = env->GetMethodID(mapClass, "put", "(Ljava/lang/Object;Ljava/lang/Object;)Ljava/lang/Object;");
+    const auto &javaBindings = getJavaBindings();
+    jobject hashMap = env->NewObject(javaBindings.hashMapClass, javaBindings.hashMapConstructor);
+    jmethodID put = javaBindings.hashMapPutMethod;
 
     std::map<std::string, std::string>::const_iterator citr = map.begin();
     for( ; citr != map.end(); ++citr) {
@@ -192,22 +188,14 @@ jobject stlStringStringMapToJavaHashMap(JNIEnv *env, const std::map<std::string,
         env->DeleteLocalRef(valueJava);
     }
 
-    jobject hashMapGobal = static_cast<jobject>(env->NewGlobalRef(hashMap));
-    env->DeleteLocalRef(hashMap);
-    env->DeleteLocalRef(mapClass);
-
-    return hashMapGobal;
+    return hashMap;
 }
 
 
 jobject stlStringVectorStringMapToJavaHashMap(JNIEnv *env, const std::map<std::string, std::vector<std::string>>& map) {
-    jclass mapClass = env->FindClass("java/util/HashMap");
-    if(mapClass == NULL)
-        return NULL;
-
-    jmethodID init = env->GetMethodID(mapClass, "<init>", "()V");
-    jobject hashMap = env->NewObject(mapClass, init);
-    jmethodID put = env->GetMethodID(mapClass, "put", "(Ljava/lang/Object;Ljava/lang/Object;)Ljava/lang/Object;");
+    const auto &javaBindings = getJavaBindings();
+    jobject hashMap = env->NewObject(javaBindings.hashMapClass, javaBindings.hashMapConstructor);
+    jmethodID put = javaBindings.hashMapPutMethod;
 
     for (const auto& citr : map) {
         jstring keyJava = env->NewStringUTF(citr.first.c_str());
@@ -218,71 +206,26 @@ jobject stlStringVectorStringMapToJavaHashMap(JNIEnv *env, const std::map<std::s
         env->DeleteLocalRef(valueJava);
     }
 
-    auto hashMapGobal = static_cast<jobject>(env->NewGlobalRef(hashMap));
-    env->DeleteLocalRef(hashMap);
-    env->DeleteLocalRef(mapClass);
-    return hashMapGobal;
+    return hashMap;
 }
 
 // Based on android platform code from: /media/jni/android_media_MediaMetadataRetriever.cpp
 void JavaHashMapToStlStringStringVectorMap(JNIEnv *env, jobject hashMap, std::map<std::string, std::vector<std::string>>& mapOut) {
+    const auto &javaBindings = getJavaBindings();
     // Get the Map's entry Set.
-    jclass mapClass = env->FindClass("java/util/Map");
-    if (mapClass == nullptr) {
-        return;
-    }
-    jmethodID entrySet =
-            env->GetMethodID(mapClass, "entrySet", "()Ljava/util/Set;");
-    if (entrySet == nullptr) {
-        return;
-    }
-    jobject set = env->CallObjectMethod(hashMap, entrySet);
+    jobject set = env->CallObjectMethod(hashMap, javaBindings.mapEntrySetMethod);
     if (set == nullptr) {
         return;
     }
     // Obtain an iterator over the Set
-    jclass setClass = env->FindClass("java/util/Set");
-    if (setClass == nullptr) {
-        return;
-    }
-    jmethodID iterator =
-            env->GetMethodID(setClass, "iterator", "()Ljava/util/Iterator;");
-    if (iterator == nullptr) {
-        return;
-    }
-    jobject iter = env->CallObjectMethod(set, iterator);
+    jobject iter = env->CallObjectMethod(set, javaBindings.setIteratorMethod);
     if (iter == nullptr) {
         return;
     }
-    // Get the Iterator method IDs
-    jclass iteratorClass = env->FindClass("java/util/Iterator");
-    if (iteratorClass == nullptr) {
-        return;
-    }
-    jmethodID hasNext = env->GetMethodID(iteratorClass, "hasNext", "()Z");
-    if (hasNext == nullptr) {
-        return;
-    }
-    jmethodID next =
-            env->GetMethodID(iteratorClass, "next", "()Ljava/lang/Object;");
-    if (next == nullptr) {
-        return;
-    }
-    // Get the Entry class method IDs
-    jclass entryClass = env->FindClass("java/util/Map$Entry");
-    if (entryClass == nullptr) {
-        return;
-    }
-    jmethodID getKey =
-            env->GetMethodID(entryClass, "getKey", "()Ljava/lang/Object;");
-    if (getKey == nullptr) {
-        return;
-    }
-    jmethodID getValue =
-            env->GetMethodID(env->FindClass("java/util/Map$Entry"), "getValue", "()Ljava/lang/Object;");
-    if (getValue == nullptr) {
-        return;
-    }
+    jmethodID hasNext = javaBindings.iteratorHasNextMethod;
+    jmethodID next = javaBindings.iteratorNextMethod;
+    jmethodID getKey = javaBindings.mapEntryGetKeyMethod;
+    jmethodID getValue = javaBindings.mapEntryGetValueMethod;
     // Iterate over the entry Set
     while (env->CallBooleanMethod(iter, hasNext)) {
         jobject entry = env->CallObjectMethod(iter, next);
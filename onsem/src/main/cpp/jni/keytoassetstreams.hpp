@@ -1,7 +1,11 @@
 #ifndef SEMANTIC_ANDROID_KEYTOFASSETSTREAMS_HPP
 #define SEMANTIC_ANDROID_KEYTOFASSETSTREAMS_HPP
 
+#include <functional>
+#include <map>
 #include <streambuf>
+#include <stdexcept>
+#include <vector>
 #include <jni.h>
 #include <iostream>
 #include <string>
@@ -11,6 +15,8 @@
 #include <onsem/common/keytostreams.hpp>
 #include <onsem/texttosemantic/linguisticanalyzer.hpp>
 #include <onsem/texttosemantic/dbtype/linguisticdatabase.hpp>
+#include "assetsources.hpp"
+#include "paralleltasks.hpp"
 
 
 
@@ -22,6 +28,8 @@ public:
     AssetStreambuf(AAssetManager *manager, const std::string &filename)
             : manager(manager) {
         asset = AAssetManager_open(manager, filename.c_str(), AASSET_MODE_STREAMING);
+        if (asset == nullptr)
+            throw std::runtime_error("asset not found: " + filename);
         buffer.resize(1024);
 
         setg(0, 0, 0);
@@ -92,63 +100,99 @@ private:
 
 /**
  * Class to store the istreams to construct a linguistic database.
+ * The files are only opened by openFiles(), on several threads, because opening a file
+ * also loads its content in memory.
  */
 struct LinguisticDatabaseStreamsWithStorage {
+    explicit LinguisticDatabaseStreamsWithStorage(const AssetSource &pAssetSource)
+            : assetSource(pAssetSource) {
+    }
+
+    const AssetSource &assetSource;
     std::list<std::unique_ptr<std::istream>> assetStreams;
     onsem::linguistics::LinguisticDatabaseStreams linguisticDatabaseStreams;
+    /// The files added for each language, the files of all the languages are with the unknown language.
+    std::map<onsem::SemanticLanguageEnum, std::vector<std::string>> languageToFilenames;
 
-    void addConceptFStream(
-            AAssetManager *pAssetMgr,
-            const std::string &pFilename) {
-        assetStreams.push_back(
-                std::make_unique<AssetIstream>(pAssetMgr, pFilename));
-        linguisticDatabaseStreams.concepts = &*assetStreams.back();
+    void addConceptFStream(const std::string &pFilename) {
+        _addFile(onsem::SemanticLanguageEnum::UNKNOWN, pFilename, [this](std::istream &pStream) {
+            linguisticDatabaseStreams.concepts = &pStream;
+        });
     }
 
-    void addDynamicContentFStream(
-            AAssetManager *pAssetMgr,
-            const std::string &pFilename) {
-        assetStreams.push_back(
-                std::make_unique<AssetIstream>(pAssetMgr, pFilename));
-        linguisticDatabaseStreams.dynamicContentStreams.push_back(&*assetStreams.back());
+    void addDynamicContentFStream(const std::string &pFilename) {
+        _addFile(onsem::SemanticLanguageEnum::UNKNOWN, pFilename, [this](std::istream &pStream) {
+            linguisticDatabaseStreams.dynamicContentStreams.push_back(&pStream);
+        });
     }
 
     void addMainDicFile(
             onsem::SemanticLanguageEnum pLanguage,
-            const std::string &pFilename,
-            AAssetManager *pAssetMgr) {
-        assetStreams.push_back(std::make_unique<AssetIstream>(pAssetMgr, pFilename));
-        linguisticDatabaseStreams.languageToStreams[pLanguage].mainDicToStream = assetStreams.back().get();
+            const std::string &pFilename) {
+        _addFile(pLanguage, pFilename, [this, pLanguage](std::istream &pStream) {
+            linguisticDatabaseStreams.languageToStreams[pLanguage].mainDicToStream = &pStream;
+        });
     }
 
     void addSynthesizerFile(
             onsem::SemanticLanguageEnum pLanguage,
-            const std::string &pFilename,
-            AAssetManager *pAssetMgr) {
-        assetStreams.push_back(std::make_unique<AssetIstream>(pAssetMgr, pFilename));
-        linguisticDatabaseStreams.languageToStreams[pLanguage].synthesizerToStream = assetStreams.back().get();
+            const std::string &pFilename) {
+        _addFile(pLanguage, pFilename, [this, pLanguage](std::istream &pStream) {
+            linguisticDatabaseStreams.languageToStreams[pLanguage].synthesizerToStream = &pStream;
+        });
     }
 
     void addFile(
             onsem::SemanticLanguageEnum pInLanguage,
             onsem::SemanticLanguageEnum pOutLanguage,
-            const std::string &pFilename,
-            AAssetManager *pAssetMgr) {
-        assetStreams.push_back(std::make_unique<AssetIstream>(pAssetMgr, pFilename));
-        linguisticDatabaseStreams.languageToStreams[pInLanguage].
-                translationStreams[pOutLanguage] = &*assetStreams.back();
+            const std::string &pFilename) {
+        _addFile(pInLanguage, pFilename, [this, pInLanguage, pOutLanguage](std::istream &pStream) {
+            linguisticDatabaseStreams.languageToStreams[pInLanguage].
+                    translationStreams[pOutLanguage] = &pStream;
+        });
     }
 
 
     void addConversationsFile(
             onsem::SemanticLanguageEnum pLanguage,
-            const std::string &pFilename,
-            AAssetManager *pAssetMgr) {
-        assetStreams.push_back(std::make_unique<AssetIstream>(pAssetMgr, pFilename));
-        linguisticDatabaseStreams.languageToStreams[pLanguage].conversionsStreams.emplace(
-                pFilename, &*assetStreams.back());
+            const std::string &pFilename) {
+        _addFile(pLanguage, pFilename, [this, pLanguage, pFilename](std::istream &pStream) {
+            linguisticDatabaseStreams.languageToStreams[pLanguage].conversionsStreams.emplace(
+                    pFilename, &pStream);
+        });
+    }
+
+    /**
+     * Open the files added since the last call, on pNbOfThreads threads.
+     * The streams are stored in the order of the additions, so the result does not depend on the threads.
+     */
+    void openFiles(std::size_t pNbOfThreads) {
+        const auto nbOfFiles = _filesToOpen.size();
+        std::vector<std::unique_ptr<std::istream>> streams(nbOfFiles);
+        runInParallel(nbOfFiles, pNbOfThreads, [&](std::size_t pFileIndex) {
+            streams[pFileIndex] = assetSource.open(_filesToOpen[pFileIndex].filename);
+        });
+
+        for (std::size_t i = 0; i < nbOfFiles; ++i) {
+            assetStreams.push_back(std::move(streams[i]));
+            _filesToOpen[i].setStream(*assetStreams.back());
+        }
+        _filesToOpen.clear();
     }
 
+private:
+    struct FileToOpen {
+        std::string filename;
+        std::function<void(std::istream &)> setStream;
+    };
+    std::vector<FileToOpen> _filesToOpen;
+
+    void _addFile(onsem::SemanticLanguageEnum pLanguage,
+                  const std::string &pFilename,
+                  std::function<void(std::istream &)> pSetStream) {
+        languageToFilenames[pLanguage].push_back(pFilename);
+        _filesToOpen.push_back(FileToOpen{pFilename, std::move(pSetStream)});
+    }
 };
 
 
@@ -0,0 +1,205 @@
+#include "languageidentifier.hpp"
+#include <cctype>
+#include <cstdint>
+#include <unordered_map>
+#include <onsem/texttosemantic/dbtype/linguisticdatabase.hpp>
+#include <onsem/texttosemantic/languagedetector.hpp>
+#include "parsecache.hpp"
+
+using namespace onsem;
+
+
+namespace {
+    /// Score from which the trigrams of a language settle the language.
+    constexpr int _minTrigramScore = 3;
+    /// The trigrams of the settled language have to score at least this times more than the other language.
+    constexpr int _minTrigramScoreRatio = 3;
+    /// Score of a letter with a diacritic that is only French in the supported languages (e.g. "é").
+    constexpr int _frenchDiacriticScore = 2;
+    /// Number of words from which the trigrams and the diacritics can settle the language.
+    constexpr std::size_t _minNbOfWordsForTrigrams = 3;
+
+
+    struct TrigramScores {
+        int french = 0;
+        int english = 0;
+    };
+
+
+    /// The trigrams are computed on the lower case words surrounded by spaces, so " th" is a beginning of word.
+    const std::unordered_map<std::string, TrigramScores> &_trigramToScores() {
+        static const std::unordered_map<std::string, TrigramScores> trigramToScores = []() {
+            std::unordered_map<std::string, TrigramScores> res;
+            for (const char *currTrigram : {" je", "je ", " tu", "tu ", "vou", " qu", "qu'", "que", " c'",
+                                            " j'", " l'", " d'", " n'", " s'", "eux", "aux", "ez ", "ais",
+                                            "ait", " du", " au", " et", " le", " la", " un"})
+                ++res[currTrigram].french;
+            for (const char *currTrigram : {" th", "the", "he ", " an", "and", "nd ", "ing", "ng ", " wh",
+                                            "hat", " yo", "you", " i ", "ght", "ly ", "'s ", "n't", " is",
+                                            " it", " of", " to", " my", " do", "can", "oul"})
+                ++res[currTrigram].english;
+            return res;
+        }();
+        return trigramToScores;
+    }
+
+
+    /// Decode the UTF-8 character at pPos and move pPos after it. (an invalid byte is returned as it is)
+    std::uint32_t _nextCodePoint(const std::string &pText, std::size_t &pPos) {
+        auto firstByte = static_cast<unsigned char>(pText[pPos++]);
+        std::size_t nbOfContinuationBytes = 0;
+        std::uint32_t res = firstByte;
+        if ((firstByte & 0xE0) == 0xC0) {
+            nbOfContinuationBytes = 1;
+            res = firstByte & 0x1F;
+        } else if ((firstByte & 0xF0) == 0xE0) {
+            nbOfContinuationBytes = 2;
+            res = firstByte & 0x0F;
+        } else if ((firstByte & 0xF8) == 0xF0) {
+            nbOfContinuationBytes = 3;
+            res = firstByte & 0x07;
+        }
+        for (std::size_t i = 0; i < nbOfContinuationBytes; ++i) {
+            if (pPos >= pText.size() || (static_cast<unsigned char>(pText[pPos]) & 0xC0) != 0x80)
+                return firstByte;
+            res = (res << 6) | (static_cast<unsigned char>(pText[pPos++]) & 0x3F);
+        }
+        return res;
+    }
+
+
+    bool _isKana(std::uint32_t pCodePoint) {
+        return (pCodePoint >= 0x3040 && pCodePoint <= 0x30FF) || (pCodePoint >= 0xFF66 && pCodePoint <= 0xFF9F);
+    }
+
+    bool _isCjkIdeograph(std::uint32_t pCodePoint) {
+        return (pCodePoint >= 0x4E00 && pCodePoint <= 0x9FFF) || (pCodePoint >= 0x3400 && pCodePoint <= 0x4DBF);
+    }
+
+    bool _isLatinLetterWithDiacritic(std::uint32_t pCodePoint) {
+        return pCodePoint >= 0xC0 && pCodePoint <= 0x24F && pCodePoint != 0xD7 && pCodePoint != 0xF7;
+    }
+
+    bool _isFrenchDiacritic(std::uint32_t pCodePoint) {
+        switch (pCodePoint) {
+            case 0xE0: case 0xE2: case 0xE6: case 0xE7: case 0xE8: case 0xE9: case 0xEA: case 0xEB:
+            case 0xEE: case 0xEF: case 0xF4: case 0xF9: case 0xFB: case 0x153:
+            case 0xC0: case 0xC2: case 0xC6: case 0xC7: case 0xC8: case 0xC9: case 0xCA: case 0xCB:
+            case 0xCE: case 0xCF: case 0xD4: case 0xD9: case 0xDB: case 0x152:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+
+    std::string _languageCacheKey(const std::string &pText) {
+        return normalizeTextForParseCache(pText);
+    }
+
+
+    bool _settle(SemanticLanguageEnum pFoundLanguage,
+                 const std::set<SemanticLanguageEnum> &pLanguages,
+                 SemanticLanguageEnum &pLanguage) {
+        if (pLanguages.count(pFoundLanguage) == 0)
+            return false;
+        pLanguage = pFoundLanguage;
+        return true;
+    }
+}
+
+
+bool prefilterLanguage(const std::string &pText,
+                       const std::set<SemanticLanguageEnum> &pLanguages,
+                       SemanticLanguageEnum &pLanguage) {
+    std::size_t nbOfKanas = 0;
+    std::size_t nbOfCjkIdeographs = 0;
+    std::size_t nbOfLatinLetters = 0;
+    int frenchDiacriticsScore = 0;
+    // Lower case ASCII words separated by one space, the other letters are replaced by a '?'
+    std::string words = " ";
+    for (std::size_t pos = 0; pos < pText.size();) {
+        auto codePoint = _nextCodePoint(pText, pos);
+        if (_isKana(codePoint)) {
+            ++nbOfKanas;
+        } else if (_isCjkIdeograph(codePoint)) {
+            ++nbOfCjkIdeographs;
+        } else if (codePoint < 0x80 && std::isalpha(static_cast<int>(codePoint))) {
+            ++nbOfLatinLetters;
+            words += static_cast<char>(std::tolower(static_cast<int>(codePoint)));
+            continue;
+        } else if (_isLatinLetterWithDiacritic(codePoint)) {
+            ++nbOfLatinLetters;
+            if (_isFrenchDiacritic(codePoint))
+                frenchDiacriticsScore += _frenchDiacriticScore;
+            words += '?';
+            continue;
+        } else if (codePoint == '\'' || codePoint == 0x2019) {
+            words += '\'';
+            continue;
+        }
+        if (words.back() != ' ')
+            words += ' ';
+    }
+    if (words.back() != ' ')
+        words += ' ';
+
+    // The kanas are only Japanese, and Japanese is the only supported language that uses the ideographs
+    if (nbOfKanas > 0 || (nbOfCjkIdeographs > 0 && nbOfLatinLetters == 0))
+        return _settle(SemanticLanguageEnum::JAPANESE, pLanguages, pLanguage);
+    // Only numbers and punctuation
+    if (nbOfCjkIdeographs == 0 && nbOfLatinLetters == 0) {
+        pLanguage = SemanticLanguageEnum::UNKNOWN;
+        return true;
+    }
+    if (nbOfCjkIdeographs > 0)
+        return false;
+    std::size_t nbOfWords = 0;
+    for (std::size_t i = 1; i < words.size(); ++i)
+        if (words[i] == ' ')
+            ++nbOfWords;
+    if (nbOfWords < _minNbOfWordsForTrigrams)
+        return false;
+
+    TrigramScores scores;
+    scores.french = frenchDiacriticsScore;
+    const auto &trigramToScores = _trigramToScores();
+    for (std::size_t i = 0; i + 3 <= words.size(); ++i) {
+        auto it = trigramToScores.find(words.substr(i, 3));
+        if (it != trigramToScores.end()) {
+            scores.french += it->second.french;
+            scores.english += it->second.english;
+        }
+    }
+    if (scores.french >= _minTrigramScore && scores.french >= _minTrigramScoreRatio * scores.english)
+        return _settle(SemanticLanguageEnum::FRENCH, pLanguages, pLanguage);
+    if (scores.english >= _minTrigramScore && scores.english >= _minTrigramScoreRatio * scores.french)
+        return _settle(SemanticLanguageEnum::ENGLISH, pLanguages, pLanguage);
+    return false;
+}
+
+
+LanguageIdentifier::LanguageIdentifier(std::shared_ptr<linguistics::LinguisticDatabase> pLingDb,
+                                       std::set<SemanticLanguageEnum> pLanguages,
+                                       std::size_t pCacheMaxSize)
+        : _lingDb(std::move(pLingDb)),
+          _languages(std::move(pLanguages)),
+          _textToLanguage(pCacheMaxSize) {
+}
+
+
+SemanticLanguageEnum LanguageIdentifier::identify(const std::string &pText) {
+    SemanticLanguageEnum res = SemanticLanguageEnum::UNKNOWN;
+    if (identifyQuickly(pText, res))
+        return res;
+    res = linguistics::getLanguage(pText, *_lingDb);
+    _textToLanguage.put(_languageCacheKey(pText), res);
+    return res;
+}
+
+
+bool LanguageIdentifier::identifyQuickly(const std::string &pText, SemanticLanguageEnum &pLanguage) {
+    // The prefilters do not take the lock of the cache
+    return prefilterLanguage(pText, _languages, pLanguage) ||
+           _textToLanguage.get(_languageCacheKey(pText), pLanguage);
+}
\ No newline at end of file
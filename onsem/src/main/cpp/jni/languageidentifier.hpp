@@ -0,0 +1,61 @@
+#ifndef SEMANTIC_ANDROID_LANGUAGEIDENTIFIER_HPP
+#define SEMANTIC_ANDROID_LANGUAGEIDENTIFIER_HPP
+
+#include <cstddef>
+#include <memory>
+#include <set>
+#include <string>
+#include <onsem/common/enum/semanticlanguageenum.hpp>
+#include "lrucache.hpp"
+
+namespace onsem {
+    namespace linguistics {
+        struct LinguisticDatabase;
+    }
+}
+
+
+/**
+ * Identify the language of the texts of a linguistic database.
+ * The obvious cases are settled by the script of the text and by its character trigrams,
+ * the other texts are looked up in the dictionaries of the linguistic database.
+ * The prefilters only return the languages given at the construction, and the dictionaries only return
+ * the languages loaded in the linguistic database. (or the unknown language)
+ * The results are kept in a cache of a bounded size.
+ * The linguistic database is never modified, so it can be used from several threads without lock.
+ */
+class LanguageIdentifier {
+public:
+    /// @param pLanguages The languages that the prefilters can return: the languages loaded in pLingDb,
+    /// and the languages that can still be loaded if the languages are loaded on demand.
+    LanguageIdentifier(std::shared_ptr<onsem::linguistics::LinguisticDatabase> pLingDb,
+                       std::set<onsem::SemanticLanguageEnum> pLanguages,
+                       std::size_t pCacheMaxSize);
+
+    onsem::SemanticLanguageEnum identify(const std::string &pText);
+
+    /// Identify the language only from the cache and from the prefilters.
+    /// @return False if the dictionaries are needed.
+    bool identifyQuickly(const std::string &pText, onsem::SemanticLanguageEnum &pLanguage);
+
+private:
+    std::shared_ptr<onsem::linguistics::LinguisticDatabase> _lingDb;
+    const std::set<onsem::SemanticLanguageEnum> _languages;
+    LruCache<onsem::SemanticLanguageEnum> _textToLanguage;
+};
+
+
+/**
+ * Identify the language of a text without dictionary, from its script (e.g. the kana are only Japanese)
+ * and from the character trigrams that are frequent in only one language.
+ * The texts of a few words are left to the dictionaries, because one word of another language can be enough
+ * to give them the wrong language. (e.g. "le the")
+ * @param pLanguages The languages that can be returned, a text of another language is ambiguous.
+ * @return False if the text is ambiguous.
+ */
+bool prefilterLanguage(const std::string &pText,
+                       const std::set<onsem::SemanticLanguageEnum> &pLanguages,
+                       onsem::SemanticLanguageEnum &pLanguage);
+
+
+#endif // SEMANTIC_ANDROID_LANGUAGEIDENTIFIER_HPP
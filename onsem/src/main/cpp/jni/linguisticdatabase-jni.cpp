@@ -1,78 +1,108 @@
 #include "linguisticdatabase-jni.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <sstream>
+#include <tuple>
+#include <vector>
 #include <android/asset_manager.h>
 #include <android/asset_manager_jni.h>
 #include "onsem-jni.h"
 #include <onsem/common/enum/semanticlanguageenum.hpp>
 #include "jobjectstocpptypes.hpp"
+#include "assetsources.hpp"
 #include "keytoassetstreams.hpp"
+#include "paralleltasks.hpp"
+#include "objectregistry.hpp"
+#include "triggercache.hpp"
+#include "parsecache.hpp"
+#include "languageidentifier.hpp"
+#include "javabindings.hpp"
 
 
 using namespace onsem;
 
 namespace {
-    std::map<jint, linguistics::LinguisticDatabase> _idToLingDb;
-    std::size_t numberOfLinguisticDatabasesCreatedSinceBeginOfRunTime = 0;
-}
-
+    std::atomic<std::size_t> numberOfLinguisticDatabasesCreatedSinceBeginOfRunTime(0);
+    /// Number of texts whose language is kept, the texts are mostly short utterances.
+    constexpr std::size_t _languageIdentifierCacheMaxSize = 1024;
 
-linguistics::LinguisticDatabase &getLingDb(int pLingDbId) {
-    auto it = _idToLingDb.find(pLingDbId);
-    if (it == _idToLingDb.end()) {
-        std::stringstream ssErrorMessage;
-        ssErrorMessage << "wrong linguistic database id: " << pLingDbId;
-        throw std::runtime_error(ssErrorMessage.str());
+    std::set<SemanticLanguageEnum> _toLanguages(JNIEnv *env, jobjectArray localesArray) {
+        std::set<SemanticLanguageEnum> res;
+        int size = env->GetArrayLength(localesArray);
+        for (int i = 0; i < size; ++i) {
+            shared_jobject locale(env, env->GetObjectArrayElement(localesArray, i));
+            res.insert(toLanguage(env, locale.get()));
+        }
+        return res;
     }
-    return it->second;
-}
 
-linguistics::LinguisticDatabase &getLingDb(JNIEnv *env, jobject pLingDb) {
-    return getLingDb(toDisposableWithIdId(env, pLingDb));
-}
 
-extern "C"
-JNIEXPORT jint JNICALL
-Java_com_onsem_LinguisticDatabaseKt_newLinguisticDatabase(
-        JNIEnv *env, jclass /*clazz*/, jobject assetManager, jobjectArray localesArray,
-        jstring jlinguisticDatabasesRootFolder) {
+    constexpr std::uint64_t _hashOffsetBasis = 14695981039346656037ULL;
+    constexpr std::uint64_t _hashPrime = 1099511628211ULL;
 
-    // This relative path is hard coded in the binary that generates the databases.
-    const std::string linguisticFolder = toString(env, jlinguisticDatabasesRootFolder);
-    const std::string binaryDatabaseFolder = linguisticFolder + "/databases";
-    const std::string binaryDatabaseFolderWithSlash = binaryDatabaseFolder + "/";
+    void _hashBytes(std::uint64_t &pHash, const char *pData, std::size_t pSize) {
+        std::size_t i = 0;
+        // 8 bytes at a time, the databases are big
+        for (; i + sizeof(std::uint64_t) <= pSize; i += sizeof(std::uint64_t)) {
+            std::uint64_t word;
+            std::memcpy(&word, pData + i, sizeof(word));
+            pHash = (pHash ^ word) * _hashPrime;
+            pHash ^= pHash >> 32;
+        }
+        for (; i < pSize; ++i)
+            pHash = (pHash ^ static_cast<unsigned char>(pData[i])) * _hashPrime;
+    }
 
-    return convertCppExceptionsToJavaExceptionsAndReturnTheResult<jint>(env, [&]() {
-        AAssetManager *assetMgr = AAssetManager_fromJava(env, assetManager);
+    void _hashStream(std::uint64_t &pHash, std::istream &pStream) {
+        std::vector<char> buffer(64 * 1024);
+        while (pStream.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) || pStream.gcount() > 0)
+            _hashBytes(pHash, buffer.data(), static_cast<std::size_t>(pStream.gcount()));
+    }
 
-        std::set<SemanticLanguageEnum> languages;
-        int size = env->GetArrayLength(localesArray);
-        for (int i = 0; i < size; ++i) {
-            shared_jobject locale(env, env->GetObjectArrayElement(localesArray, i));
-            languages.insert(toLanguage(env, locale.get()));
-        }
-        languages.insert(SemanticLanguageEnum::UNKNOWN);
 
-        LinguisticDatabaseStreamsWithStorage iStreams;
-        iStreams.addConceptFStream(assetMgr, binaryDatabaseFolder + "/concepts.bdb");
+    /// The unknown language is the language-agnostic core, it has to be in pLanguages.
+    /// @param pLanguageToFilenames Filled with the files used by each language, cf LinguisticDatabaseStreamsWithStorage.
+    std::shared_ptr<linguistics::LinguisticDatabase> _newLinguisticDatabase(
+            const std::set<SemanticLanguageEnum> &pLanguages,
+            const std::string &linguisticFolder,
+            const AssetSource &pAssetSource,
+            std::map<SemanticLanguageEnum, std::vector<std::string>> &pLanguageToFilenames) {
+        // This relative path is hard coded in the binary that generates the databases.
+        const std::string binaryDatabaseFolder = linguisticFolder + "/databases";
+        const std::string binaryDatabaseFolderWithSlash = binaryDatabaseFolder + "/";
 
-        for (auto language : languages) {
+        // The files are parsed by the constructor of the database at each construction.
+        // A prebuilt image of the constructed database cannot be mapped instead: the onsem library only
+        // constructs a database from LinguisticDatabaseStreams, and its internal structures (tries, maps and
+        // pointers between the words, the concepts and the meanings) have no relocatable serialization.
+        // The mapped assets already give the files to the constructor without copy. (cf MappedAssetSource)
+
+        LinguisticDatabaseStreamsWithStorage iStreams(pAssetSource);
+        iStreams.addConceptFStream(binaryDatabaseFolder + "/concepts.bdb");
+
+        for (auto language : pLanguages) {
             auto languageFileName = semanticLanguageEnum_toLanguageFilenameStr(language);
             iStreams.addMainDicFile(language, binaryDatabaseFolderWithSlash + languageFileName +
-                                              "database.bdb",
-                                    assetMgr);
+                                              "database.bdb");
             iStreams.addSynthesizerFile(language,
                                         binaryDatabaseFolderWithSlash + languageFileName +
-                                        "synthesizer.bdb",
-                                        assetMgr);
+                                        "synthesizer.bdb");
 
             if (language != SemanticLanguageEnum::UNKNOWN) {
-                for (auto secondLanguage : languages) {
+                for (auto secondLanguage : pLanguages) {
                     if (language != secondLanguage &&
                         secondLanguage != SemanticLanguageEnum::UNKNOWN) {
                         auto filename = binaryDatabaseFolder + "/" +
                                         semanticLanguageEnum_toLegacyStr(language) + "_to_" +
                                         semanticLanguageEnum_toLegacyStr(secondLanguage) +
                                         ".bdb";
-                        iStreams.addFile(language, secondLanguage, filename, assetMgr);
+                        iStreams.addFile(language, secondLanguage, filename);
                     }
                 }
             }
@@ -81,59 +111,448 @@ Java_com_onsem_LinguisticDatabaseKt_newLinguisticDatabase(
         {
             std::string wordsrelativePathsFilename =
                     linguisticFolder + "/wordsrelativePaths.txt";
-            std::istream wordsrelativePathsFile(
-                    new AssetStreambuf(assetMgr, wordsrelativePathsFilename));
+            auto wordsrelativePathsFile = pAssetSource.open(wordsrelativePathsFilename);
             const std::string wordsFolderWithSlash =
                     linguisticFolder + "/dynamicdictionary/words/";
             std::string line;
-            while (getline(wordsrelativePathsFile, line))
+            while (getline(*wordsrelativePathsFile, line))
                 if (!line.empty())
-                    iStreams.addDynamicContentFStream(assetMgr, wordsFolderWithSlash + line);
+                    iStreams.addDynamicContentFStream(wordsFolderWithSlash + line);
         }
 
         {
             std::string treeConvertionsPathsFilename =
                     linguisticFolder + "/treeConvertionsPaths.txt";
-            std::istream treeConvertionsPathsFile(
-                    new AssetStreambuf(assetMgr, treeConvertionsPathsFilename));
+            auto treeConvertionsPathsFile = pAssetSource.open(treeConvertionsPathsFilename);
             SemanticLanguageEnum currentLanguage = SemanticLanguageEnum::UNKNOWN;
             const std::string treeConversionsFolderWithSlash =
                     linguisticFolder + "/dynamicdictionary/treeconversions/";
             std::string line;
-            while (getline(treeConvertionsPathsFile, line)) {
+            while (getline(*treeConvertionsPathsFile, line)) {
                 if (line.empty())
                     continue;
                 if (line[0] == '#')
                     currentLanguage = semanticLanguageEnum_fromLanguageFilenameStr(
                             line.substr(1, line.size() - 1));
-                else
+                else if (pLanguages.count(currentLanguage) > 0)
                     iStreams.addConversationsFile(currentLanguage,
-                                                  treeConversionsFolderWithSlash + line,
-                                                  assetMgr);
+                                                  treeConversionsFolderWithSlash + line);
             }
         }
 
-        jint lingDbId = 0;
-        protectByMutex([&] {
-            ++numberOfLinguisticDatabasesCreatedSinceBeginOfRunTime;
-            lingDbId = findMissingKey(_idToLingDb);
-            _idToLingDb.emplace(lingDbId, iStreams.linguisticDatabaseStreams);
+        iStreams.openFiles(getNbOfWorkerThreads());
+
+        auto res = std::make_shared<linguistics::LinguisticDatabase>(iStreams.linguisticDatabaseStreams);
+        ++numberOfLinguisticDatabasesCreatedSinceBeginOfRunTime;
+        pLanguageToFilenames = std::move(iStreams.languageToFilenames);
+        return res;
+    }
+
+
+    /// The languages that have tree conversions in the linguistic folder, so the languages that can be loaded.
+    std::set<SemanticLanguageEnum> _readLoadableLanguages(const std::string &linguisticFolder,
+                                                          const AssetSource &pAssetSource) {
+        std::set<SemanticLanguageEnum> res;
+        auto treeConvertionsPathsFile = pAssetSource.open(linguisticFolder + "/treeConvertionsPaths.txt");
+        std::string line;
+        while (getline(*treeConvertionsPathsFile, line))
+            if (!line.empty() && line[0] == '#')
+                res.insert(semanticLanguageEnum_fromLanguageFilenameStr(line.substr(1, line.size() - 1)));
+        return res;
+    }
+
+
+    /**
+     * Linguistic database of a java LinguisticDatabase object, with what is needed to load more languages.
+     * To load a language, a new linguistic database is constructed with this language in addition to the
+     * languages already loaded, and it replaces the previous one.
+     * The objects that still use the previous linguistic database keep it alive.
+     * So each loading costs a construction of all the languages and, during it, the memory of the two databases:
+     * the languages that are loaded together (cf preloadLanguagesCpp) are constructed only once.
+     * (the onsem library cannot add a language to a constructed database)
+     */
+    class LinguisticDatabaseLoader {
+    public:
+        LinguisticDatabaseLoader(std::unique_ptr<JavaGlobalRef> pAssetManager,
+                                 std::unique_ptr<AssetSource> pAssetSource,
+                                 std::string pLinguisticFolder,
+                                 bool pLoadLanguagesOnDemand)
+                : _assetManager(std::move(pAssetManager)),
+                  _assetSource(std::move(pAssetSource)),
+                  _linguisticFolder(std::move(pLinguisticFolder)),
+                  _loadLanguagesOnDemand(pLoadLanguagesOnDemand),
+                  _loadingMutex(),
+                  _mutex(),
+                  _loadableLanguages(),
+                  _languages(),
+                  _languageToFilenames(),
+                  _lingDb(),
+                  _languageIdentifier(),
+                  _databaseVersionsMutex(),
+                  _languageToDatabaseVersion() {
+        }
+
+        void loadLanguages(const std::set<SemanticLanguageEnum> &pLanguages) {
+            std::lock_guard<std::mutex> loadingLock(_loadingMutex);
+            auto languages = pLanguages;
+            languages.insert(SemanticLanguageEnum::UNKNOWN);
+            {
+                std::shared_lock<std::shared_mutex> lock(_mutex);
+                if (_lingDb && std::includes(_languages.begin(), _languages.end(),
+                                             languages.begin(), languages.end()))
+                    return;
+                languages.insert(_languages.begin(), _languages.end());
+            }
+            // The construction is long, so the previous linguistic database stays usable meanwhile
+            std::map<SemanticLanguageEnum, std::vector<std::string>> languageToFilenames;
+            auto lingDb = _newLinguisticDatabase(languages, _linguisticFolder, *_assetSource, languageToFilenames);
+            // The languages that are not loaded yet can be identified by the prefilters, so that the language
+            // of a text can be known before its loading
+            if (_loadLanguagesOnDemand && _loadableLanguages.empty())
+                _loadableLanguages = _readLoadableLanguages(_linguisticFolder, *_assetSource);
+            auto identifiableLanguages = languages;
+            identifiableLanguages.insert(_loadableLanguages.begin(), _loadableLanguages.end());
+            // The languages of the cached texts can change with the new languages
+            auto languageIdentifier = std::make_shared<LanguageIdentifier>(lingDb, std::move(identifiableLanguages),
+                                                                           _languageIdentifierCacheMaxSize);
+            std::unique_lock<std::shared_mutex> lock(_mutex);
+            _languages = std::move(languages);
+            _languageToFilenames = std::move(languageToFilenames);
+            _lingDb = std::move(lingDb);
+            _languageIdentifier = std::move(languageIdentifier);
+        }
+
+        std::shared_ptr<linguistics::LinguisticDatabase> get() const {
+            std::shared_lock<std::shared_mutex> lock(_mutex);
+            return _lingDb;
+        }
+
+        /// Get the linguistic database and load the language if it is loaded on demand.
+        std::shared_ptr<linguistics::LinguisticDatabase> get(SemanticLanguageEnum pLanguage) {
+            if (_loadLanguagesOnDemand &&
+                pLanguage != SemanticLanguageEnum::UNKNOWN && pLanguage != SemanticLanguageEnum::OTHER) {
+                {
+                    std::shared_lock<std::shared_mutex> lock(_mutex);
+                    if (_languages.count(pLanguage) > 0)
+                        return _lingDb;
+                }
+                loadLanguages({pLanguage});
+            }
+            return get();
+        }
+
+        std::shared_ptr<LanguageIdentifier> getLanguageIdentifier() const {
+            std::shared_lock<std::shared_mutex> lock(_mutex);
+            return _languageIdentifier;
+        }
+
+        /**
+         * Version of the databases used to parse a language: a hash of the content of its files
+         * and of the files common to all the languages.
+         * The files are read again at the first call for a language, then the version is kept.
+         */
+        std::string getDatabaseVersion(SemanticLanguageEnum pLanguage) {
+            std::lock_guard<std::mutex> versionsLock(_databaseVersionsMutex);
+            auto it = _languageToDatabaseVersion.find(pLanguage);
+            if (it != _languageToDatabaseVersion.end())
+                return it->second;
+
+            std::set<std::string> filenames;
+            bool languageIsLoaded = pLanguage == SemanticLanguageEnum::UNKNOWN;
+            {
+                std::shared_lock<std::shared_mutex> lock(_mutex);
+                for (auto language : {SemanticLanguageEnum::UNKNOWN, pLanguage}) {
+                    auto itFilenames = _languageToFilenames.find(language);
+                    if (itFilenames == _languageToFilenames.end())
+                        continue;
+                    filenames.insert(itFilenames->second.begin(), itFilenames->second.end());
+                    if (language == pLanguage)
+                        languageIsLoaded = true;
+                }
+            }
+            std::uint64_t hash = _hashOffsetBasis;
+            for (const auto &currFilename : filenames) {
+                _hashBytes(hash, currFilename.c_str(), currFilename.size() + 1);
+                _hashStream(hash, *_assetSource->open(currFilename));
+            }
+            std::ostringstream ss;
+            ss << std::hex << hash;
+            // The version of a language that is not loaded yet changes when it is loaded
+            if (languageIsLoaded)
+                _languageToDatabaseVersion.emplace(pLanguage, ss.str());
+            return ss.str();
+        }
+
+    private:
+        /// Keep the java asset manager alive while the asset source uses it.
+        std::unique_ptr<JavaGlobalRef> _assetManager;
+        std::unique_ptr<AssetSource> _assetSource;
+        const std::string _linguisticFolder;
+        const bool _loadLanguagesOnDemand;
+        /// Only one loading at a time.
+        std::mutex _loadingMutex;
+        /// The languages that can be loaded on demand, only read if the languages are loaded on demand.
+        /// (protected by _loadingMutex)
+        std::set<SemanticLanguageEnum> _loadableLanguages;
+        /// Protect _languages, _lingDb and _languageIdentifier, shared by the threads that only get them.
+        mutable std::shared_mutex _mutex;
+        std::set<SemanticLanguageEnum> _languages;
+        /// The files of _lingDb by language.
+        std::map<SemanticLanguageEnum, std::vector<std::string>> _languageToFilenames;
+        std::shared_ptr<linguistics::LinguisticDatabase> _lingDb;
+        /// Identify the languages with _lingDb.
+        std::shared_ptr<LanguageIdentifier> _languageIdentifier;
+        /// Protect _languageToDatabaseVersion, the hashes are long so _mutex is not held meanwhile.
+        std::mutex _databaseVersionsMutex;
+        std::map<SemanticLanguageEnum, std::string> _languageToDatabaseVersion;
+    };
+
+
+    /**
+     * What a java LinguisticDatabase object references.
+     * The loader can be shared with other java objects (cf _sharedLoaders), but the caches are enabled
+     * by each java object, so they belong to this handle and they are not used by the other java objects.
+     */
+    class LinguisticDatabaseHandle {
+    public:
+        explicit LinguisticDatabaseHandle(std::shared_ptr<LinguisticDatabaseLoader> pLoader)
+                : _loader(std::move(pLoader)),
+                  _mutex(),
+                  _triggerCache(),
+                  _parseCache() {
+        }
+
+        const std::shared_ptr<LinguisticDatabaseLoader> &loader() const {
+            return _loader;
+        }
+
+        void setTriggerCache(std::shared_ptr<TriggerCache> pTriggerCache) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _triggerCache = std::move(pTriggerCache);
+        }
+
+        std::shared_ptr<TriggerCache> getTriggerCache() const {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _triggerCache;
+        }
+
+        void setParseCache(std::shared_ptr<ParseCache> pParseCache) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _parseCache = std::move(pParseCache);
+        }
+
+        std::shared_ptr<ParseCache> getParseCache() const {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _parseCache;
+        }
+
+    private:
+        std::shared_ptr<LinguisticDatabaseLoader> _loader;
+        /// Protect the caches.
+        mutable std::mutex _mutex;
+        std::shared_ptr<TriggerCache> _triggerCache;
+        std::shared_ptr<ParseCache> _parseCache;
+    };
+
+
+    ObjectRegistry<LinguisticDatabaseHandle> _idToLingDb("linguistic database");
+
+
+    /// Parameters that identify the linguistic databases that can be shared.
+    struct LinguisticDatabaseLoaderKey {
+        std::string assetSourceType;
+        std::string linguisticFolder;
+        std::set<SemanticLanguageEnum> languages;
+        bool loadLanguagesOnDemand;
+
+        bool operator<(const LinguisticDatabaseLoaderKey &pOther) const {
+            return std::tie(assetSourceType, linguisticFolder, languages, loadLanguagesOnDemand) <
+                   std::tie(pOther.assetSourceType, pOther.linguisticFolder, pOther.languages,
+                            pOther.loadLanguagesOnDemand);
+        }
+    };
+
+    /**
+     * The linguistic databases created with the same parameters are shared.
+     * Each java object has its own handle in the registry, but the handles point to the same loader,
+     * so the loader is freed when the last java object is deleted.
+     * (the mutex is held during the construction, so that 2 threads cannot construct the same database)
+     */
+    std::mutex _sharedLoadersMutex;
+    std::map<LinguisticDatabaseLoaderKey, std::weak_ptr<LinguisticDatabaseLoader>> _sharedLoaders;
+
+
+    jint _getOrCreateLinguisticDatabaseLoader(
+            const LinguisticDatabaseLoaderKey &pKey,
+            const std::function<std::shared_ptr<LinguisticDatabaseLoader>()> &pCreateLoader) {
+        std::lock_guard<std::mutex> lock(_sharedLoadersMutex);
+        for (auto it = _sharedLoaders.begin(); it != _sharedLoaders.end();) {
+            if (it->second.expired())
+                it = _sharedLoaders.erase(it);
+            else
+                ++it;
+        }
+
+        auto it = _sharedLoaders.find(pKey);
+        auto loader = it != _sharedLoaders.end() ? it->second.lock() : nullptr;
+        if (!loader) {
+            loader = pCreateLoader();
+            loader->loadLanguages(pKey.languages);
+            _sharedLoaders[pKey] = loader;
+        }
+        return _idToLingDb.add(std::make_shared<LinguisticDatabaseHandle>(std::move(loader)));
+    }
+}
+
+
+std::shared_ptr<linguistics::LinguisticDatabase> getLingDb(int pLingDbId) {
+    return _idToLingDb.get(pLingDbId)->loader()->get();
+}
+
+std::shared_ptr<linguistics::LinguisticDatabase> getLingDb(JNIEnv *env, jobject pLingDb) {
+    return getLingDb(toDisposableWithIdId(env, pLingDb));
+}
+
+std::shared_ptr<linguistics::LinguisticDatabase> getLingDb(
+        JNIEnv *env, jobject pLingDb, SemanticLanguageEnum pLanguage) {
+    return _idToLingDb.get(toDisposableWithIdId(env, pLingDb))->loader()->get(pLanguage);
+}
+
+std::shared_ptr<TriggerCache> getTriggerCache(JNIEnv *env, jobject pLingDb) {
+    return _idToLingDb.get(toDisposableWithIdId(env, pLingDb))->getTriggerCache();
+}
+
+std::shared_ptr<ParseCache> getParseCache(JNIEnv *env, jobject pLingDb) {
+    return _idToLingDb.get(toDisposableWithIdId(env, pLingDb))->getParseCache();
+}
+
+std::shared_ptr<LanguageIdentifier> getLanguageIdentifier(JNIEnv *env, jobject pLingDb) {
+    return _idToLingDb.get(toDisposableWithIdId(env, pLingDb))->loader()->getLanguageIdentifier();
+}
+
+extern "C"
+JNIEXPORT jint JNICALL
+Java_com_onsem_LinguisticDatabaseKt_newLinguisticDatabase(
+        JNIEnv *env, jclass /*clazz*/, jobject assetManager, jobjectArray localesArray,
+        jstring jlinguisticDatabasesRootFolder, jboolean useMemoryMappedAssets,
+        jboolean loadLanguagesOnDemand) {
+    return convertCppExceptionsToJavaExceptionsAndReturnTheResult<jint>(env, [&]() {
+        AAssetManager *assetMgr = AAssetManager_fromJava(env, assetManager);
+        LinguisticDatabaseLoaderKey key{useMemoryMappedAssets ? "mappedAssets" : "streamingAssets",
+                                        toString(env, jlinguisticDatabasesRootFolder),
+                                        _toLanguages(env, localesArray),
+                                        static_cast<bool>(loadLanguagesOnDemand)};
+        return _getOrCreateLinguisticDatabaseLoader(key, [&]() {
+            std::unique_ptr<AssetSource> assetSource;
+            if (useMemoryMappedAssets)
+                assetSource = std::make_unique<MappedAssetSource>(assetMgr);
+            else
+                assetSource = std::make_unique<StreamingAssetSource>(assetMgr);
+            return std::make_shared<LinguisticDatabaseLoader>(
+                    std::make_unique<JavaGlobalRef>(env, assetManager), std::move(assetSource),
+                    key.linguisticFolder, key.loadLanguagesOnDemand);
+        });
+    }, -1);
+}
+
+
+extern "C"
+JNIEXPORT jint JNICALL
+Java_com_onsem_LinguisticDatabaseKt_newLinguisticDatabaseFromFiles(
+        JNIEnv *env, jclass /*clazz*/, jobjectArray localesArray, jstring jlinguisticDatabasesFolder,
+        jboolean loadLanguagesOnDemand) {
+    return convertCppExceptionsToJavaExceptionsAndReturnTheResult<jint>(env, [&]() {
+        LinguisticDatabaseLoaderKey key{"files",
+                                        toString(env, jlinguisticDatabasesFolder),
+                                        _toLanguages(env, localesArray),
+                                        static_cast<bool>(loadLanguagesOnDemand)};
+        return _getOrCreateLinguisticDatabaseLoader(key, [&]() {
+            return std::make_shared<LinguisticDatabaseLoader>(
+                    nullptr, std::make_unique<MappedFileSource>(), key.linguisticFolder, key.loadLanguagesOnDemand);
         });
-        return lingDbId;
     }, -1);
 }
 
 
 extern "C"
 JNIEXPORT void JNICALL
-Java_com_onsem_LinguisticDatabaseKt_deleteLinguisticDatabase(
+Java_com_onsem_LinguisticDatabaseKt_preloadLanguagesCpp(
+        JNIEnv *env, jclass /*clazz*/, jint linguisticDatabaseId, jobjectArray localesArray) {
+    convertCppExceptionsToJavaExceptions(env, [&]() {
+        _idToLingDb.get(linguisticDatabaseId)->loader()->loadLanguages(_toLanguages(env, localesArray));
+    });
+}
+
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_onsem_LinguisticDatabaseKt_useTriggerCacheCpp(
+        JNIEnv *env, jclass /*clazz*/, jint linguisticDatabaseId, jstring cacheFilenameJStr,
+        jstring libraryVersionJStr) {
+    convertCppExceptionsToJavaExceptions(env, [&]() {
+        auto lingDbHandle = _idToLingDb.get(linguisticDatabaseId);
+        // The loader does not reference the cache, so the cache can keep it alive
+        auto loader = lingDbHandle->loader();
+        lingDbHandle->setTriggerCache(std::make_shared<TriggerCache>(
+                toString(env, cacheFilenameJStr), toString(env, libraryVersionJStr),
+                [loader](SemanticLanguageEnum pLanguage) {
+                    return loader->getDatabaseVersion(pLanguage);
+                }));
+    });
+}
+
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_onsem_LinguisticDatabaseKt_saveTriggerCacheCpp(
         JNIEnv *env, jclass /*clazz*/, jint linguisticDatabaseId) {
-    protectByMutex([&] {
-        _idToLingDb.erase(linguisticDatabaseId);
+    convertCppExceptionsToJavaExceptions(env, [&]() {
+        auto triggerCache = _idToLingDb.get(linguisticDatabaseId)->getTriggerCache();
+        if (triggerCache)
+            triggerCache->save();
     });
 }
 
 
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_onsem_LinguisticDatabaseKt_useParseCacheCpp(
+        JNIEnv *env, jclass /*clazz*/, jint linguisticDatabaseId, jint maxNbOfExpressions) {
+    convertCppExceptionsToJavaExceptions(env, [&]() {
+        auto lingDbHandle = _idToLingDb.get(linguisticDatabaseId);
+        lingDbHandle->setParseCache(maxNbOfExpressions > 0 ?
+                                    std::make_shared<ParseCache>(static_cast<std::size_t>(maxNbOfExpressions)) :
+                                    nullptr);
+    });
+}
+
+
+extern "C"
+JNIEXPORT jlongArray JNICALL
+Java_com_onsem_LinguisticDatabaseKt_getParseCacheStatisticsCpp(
+        JNIEnv *env, jclass /*clazz*/, jint linguisticDatabaseId) {
+    return convertCppExceptionsToJavaExceptionsAndReturnTheResult<jlongArray>(env, [&]() {
+        auto parseCache = _idToLingDb.get(linguisticDatabaseId)->getParseCache();
+        jlong statistics[2] = {0, 0};
+        if (parseCache) {
+            statistics[0] = static_cast<jlong>(parseCache->nbOfHits());
+            statistics[1] = static_cast<jlong>(parseCache->nbOfMisses());
+        }
+        auto result = env->NewLongArray(2);
+        env->SetLongArrayRegion(result, 0, 2, statistics);
+        return result;
+    }, nullptr);
+}
+
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_onsem_LinguisticDatabaseKt_deleteLinguisticDatabase(
+        JNIEnv *env, jclass /*clazz*/, jint linguisticDatabaseId) {
+    _idToLingDb.remove(linguisticDatabaseId);
+}
+
+
 // Only for debug to spot a potential leak
 std::size_t getNumberOfLinguisticDatabasesObjects() {
     return _idToLingDb.size();
@@ -2,16 +2,31 @@
 #define SEMANTIC_ANDROID_LINGUISTICDATABASE_JNI_HPP
 
 #include <cstddef>
+#include <memory>
 #include <jni.h>
+#include <onsem/common/enum/semanticlanguageenum.hpp>
 
 namespace onsem {
     namespace linguistics {
         struct LinguisticDatabase;
     }
 }
-
-onsem::linguistics::LinguisticDatabase &getLingDb(int pLingDbId);
-onsem::linguistics::LinguisticDatabase &getLingDb(JNIEnv *env, jobject pLingDb);
+class TriggerCache;
+class ParseCache;
+class LanguageIdentifier;
+
+/// The linguistic database is never modified after its construction, so the returned pointer is only to keep it alive.
+std::shared_ptr<onsem::linguistics::LinguisticDatabase> getLingDb(int pLingDbId);
+std::shared_ptr<onsem::linguistics::LinguisticDatabase> getLingDb(JNIEnv *env, jobject pLingDb);
+/// Same as above, but the language is loaded if the languages are loaded on demand.
+std::shared_ptr<onsem::linguistics::LinguisticDatabase> getLingDb(
+        JNIEnv *env, jobject pLingDb, onsem::SemanticLanguageEnum pLanguage);
+/// The cache of the parsed triggers, or nullptr if the linguistic database does not use a cache.
+std::shared_ptr<TriggerCache> getTriggerCache(JNIEnv *env, jobject pLingDb);
+/// The cache of the parsed texts, or nullptr if the linguistic database does not use a cache.
+std::shared_ptr<ParseCache> getParseCache(JNIEnv *env, jobject pLingDb);
+/// The identifier of the languages of the texts with the languages currently loaded.
+std::shared_ptr<LanguageIdentifier> getLanguageIdentifier(JNIEnv *env, jobject pLingDb);
 
 
 
@@ -0,0 +1,72 @@
+#ifndef SEMANTIC_ANDROID_LRUCACHE_HPP
+#define SEMANTIC_ANDROID_LRUCACHE_HPP
+
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+
+/**
+ * Map of a bounded size that removes its least recently used value when it is full.
+ * It can be used from several threads, the values are copied under the lock.
+ * (so a big value should be stored through a shared pointer)
+ */
+template<typename T>
+class LruCache {
+public:
+    explicit LruCache(std::size_t pMaxSize)
+            : _maxSize(pMaxSize),
+              _mutex(),
+              _entries(),
+              _keyToEntry() {
+    }
+
+    bool get(const std::string &pKey, T &pValue) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _keyToEntry.find(pKey);
+        if (it == _keyToEntry.end())
+            return false;
+        _entries.splice(_entries.begin(), _entries, it->second);
+        pValue = it->second->second;
+        return true;
+    }
+
+    void put(const std::string &pKey, T pValue) {
+        if (_maxSize == 0)
+            return;
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _keyToEntry.find(pKey);
+        if (it != _keyToEntry.end()) {
+            it->second->second = std::move(pValue);
+            _entries.splice(_entries.begin(), _entries, it->second);
+            return;
+        }
+        _entries.emplace_front(pKey, std::move(pValue));
+        _keyToEntry.emplace(pKey, _entries.begin());
+        if (_entries.size() > _maxSize) {
+            _keyToEntry.erase(_entries.back().first);
+            _entries.pop_back();
+        }
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _keyToEntry.clear();
+        _entries.clear();
+    }
+
+private:
+    using Entry = std::pair<std::string, T>;
+
+    const std::size_t _maxSize;
+    std::mutex _mutex;
+    /// From the most recently used to the least recently used.
+    std::list<Entry> _entries;
+    std::unordered_map<std::string, typename std::list<Entry>::iterator> _keyToEntry;
+};
+
+
+#endif // SEMANTIC_ANDROID_LRUCACHE_HPP
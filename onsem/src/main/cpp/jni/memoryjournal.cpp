@@ -0,0 +1,383 @@
+#include "memoryjournal.hpp"
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <unistd.h>
+#include <onsem/semantictotext/semanticmemory/semanticmemory.hpp>
+#include <onsem/semantictotext/semexpoperators.hpp>
+#include <onsem/semantictotext/triggers.hpp>
+#include "memorysnapshot.hpp"
+#include "semanticserialization.hpp"
+
+using namespace onsem;
+
+namespace {
+    constexpr char _magic[8] = {'O', 'N', 'S', 'E', 'M', 'J', 'N', 'L'};
+    constexpr std::uint32_t _formatVersion = 1;
+    /// Maximum time that a record waits in the queue.
+    constexpr std::chrono::milliseconds _batchDelay(50);
+    /// Number of records that wakes up the thread of the journal before the batch delay.
+    constexpr std::size_t _maxBatchSize = 256;
+
+
+    bool _readHeader(std::istream &pIn, std::uint32_t &pGeneration) {
+        char magic[sizeof(_magic)];
+        if (!pIn.read(magic, sizeof(magic)) || std::memcmp(magic, _magic, sizeof(_magic)) != 0)
+            return false;
+        try {
+            if (binaryfile::readUint32(pIn) != _formatVersion)
+                return false;
+            pGeneration = binaryfile::readUint32(pIn);
+        } catch (const std::exception &) {
+            return false;
+        }
+        return true;
+    }
+}
+
+
+std::uint32_t MemoryJournal::restore(const std::string &pSnapshotFilename,
+                                     const std::string &pJournalFilename,
+                                     SemanticMemory &pSemMemory,
+                                     const linguistics::LinguisticDatabase &pLingDb) {
+    std::uint32_t generation = 0;
+    if (std::ifstream(pSnapshotFilename).good()) {
+        auto snapshot = readMemorySnapshot(pSnapshotFilename);
+        restoreMemorySnapshot(snapshot, pSemMemory, pLingDb);
+        generation = snapshot.journalGeneration;
+    }
+    _replay(pJournalFilename, generation, pSemMemory, pLingDb);
+    return generation;
+}
+
+
+void MemoryJournal::_replay(const std::string &pJournalFilename,
+                            std::uint32_t pGeneration,
+                            SemanticMemory &pSemMemory,
+                            const linguistics::LinguisticDatabase &pLingDb) {
+    std::ifstream in(pJournalFilename, std::ios::binary);
+    std::uint32_t generation = 0;
+    // A journal of another generation is already in the snapshot
+    if (!in || !_readHeader(in, generation) || generation != pGeneration)
+        return;
+
+    auto endOfLastRecord = in.tellg();
+    bool lastRecordIsTruncated = false;
+    while (in.peek() != std::char_traits<char>::eof()) {
+        std::string recordStr;
+        try {
+            recordStr = binaryfile::readString(in);
+        } catch (const std::exception &) {
+            // The process stopped during the writing of this record
+            lastRecordIsTruncated = true;
+            break;
+        }
+        endOfLastRecord = in.tellg();
+
+        try {
+            std::istringstream recordIn(recordStr);
+            auto type = static_cast<RecordType>(binaryfile::readUint32(recordIn));
+            std::vector<UniqueSemanticExpression> semExps(binaryfile::readUint32(recordIn));
+            for (auto &currSemExp : semExps)
+                currSemExp = stringToSemExp(binaryfile::readString(recordIn));
+            auto text = binaryfile::readString(recordIn);
+
+            std::size_t expectedNbOfSemExps = type == RecordType::CURRENT_USER_ID ? 0 :
+                    (type == RecordType::TRIGGER || type == RecordType::BEHAVIOR ? 2 : 1);
+            if (semExps.size() != expectedNbOfSemExps)
+                throw std::runtime_error("invalid record");
+            switch (type) {
+                case RecordType::INFORM:
+                    memoryOperation::inform(std::move(semExps[0]), pSemMemory, pLingDb);
+                    break;
+                case RecordType::INFORM_AXIOM:
+                    memoryOperation::informAxiom(std::move(semExps[0]), pSemMemory, pLingDb);
+                    break;
+                case RecordType::TRIGGER:
+                    triggers::add(std::move(semExps[0]), std::move(semExps[1]), pSemMemory, pLingDb);
+                    break;
+                case RecordType::BEHAVIOR: {
+                    mystd::unique_propagate_const<UniqueSemanticExpression> reaction;
+                    memoryOperation::teachSplitted(reaction, pSemMemory, std::move(semExps[0]), std::move(semExps[1]),
+                                                   pLingDb, memoryOperation::SemanticActionOperatorEnum::BEHAVIOR);
+                    break;
+                }
+                case RecordType::CURRENT_USER_ID:
+                    pSemMemory.setCurrUserId(text);
+                    break;
+                default:
+                    throw std::runtime_error("unknown record type");
+            }
+        } catch (const std::exception &e) {
+            std::cout << "a record of the journal " << pJournalFilename << " is ignored: " << e.what() << std::endl;
+        }
+    }
+    in.close();
+
+    // Remove the truncated record, so that the next records are appended after a valid one
+    if (lastRecordIsTruncated &&
+        ::truncate(pJournalFilename.c_str(), static_cast<off_t>(endOfLastRecord)) != 0)
+        throw std::runtime_error("cannot repair the journal " + pJournalFilename);
+}
+
+
+MemoryJournal::MemoryJournal(std::string pSnapshotFilename,
+                             std::string pJournalFilename,
+                             std::uint32_t pGeneration,
+                             std::chrono::milliseconds pCompactionInterval,
+                             std::shared_mutex &pMemoryMutex,
+                             const SemanticMemory &pSemMemory)
+        : _snapshotFilename(std::move(pSnapshotFilename)),
+          _journalFilename(std::move(pJournalFilename)),
+          _compactionInterval(pCompactionInterval),
+          _memoryMutex(pMemoryMutex),
+          _semMemory(pSemMemory),
+          _journalFile(),
+          _generation(pGeneration),
+          _mutex(),
+          _wakeUp(),
+          _stopped(false),
+          _immediateCompactionRequested(false),
+          _compactionRequested(false),
+          _records(),
+          _nbOfChangesSinceCompaction(0),
+          _firstChangeSinceCompaction(),
+          _thread() {
+    std::uint32_t generation = 0;
+    bool continueTheJournal = false;
+    {
+        std::ifstream in(_journalFilename, std::ios::binary);
+        continueTheJournal = in && _readHeader(in, generation) && generation == _generation;
+    }
+    if (continueTheJournal)
+        _journalFile.open(_journalFilename, std::ios::binary | std::ios::app);
+    else
+        _resetJournalFile();
+    if (!_journalFile)
+        throw std::runtime_error("cannot write the journal " + _journalFilename);
+    _thread = std::thread([this]() { _run(); });
+}
+
+
+MemoryJournal::~MemoryJournal() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopped = true;
+    }
+    _wakeUp.notify_one();
+    _thread.join();
+}
+
+
+void MemoryJournal::addInform(UniqueSemanticExpression pSemExp) {
+    Record record{RecordType::INFORM, {}, {}};
+    record.semExps.emplace_back(std::move(pSemExp));
+    _add(std::move(record));
+}
+
+
+void MemoryJournal::addInformAxiom(UniqueSemanticExpression pSemExp) {
+    Record record{RecordType::INFORM_AXIOM, {}, {}};
+    record.semExps.emplace_back(std::move(pSemExp));
+    _add(std::move(record));
+}
+
+
+void MemoryJournal::addTrigger(UniqueSemanticExpression pTriggerSemExp,
+                               UniqueSemanticExpression pAnswerSemExp) {
+    Record record{RecordType::TRIGGER, {}, {}};
+    record.semExps.emplace_back(std::move(pTriggerSemExp));
+    record.semExps.emplace_back(std::move(pAnswerSemExp));
+    _add(std::move(record));
+}
+
+
+void MemoryJournal::addBehavior(UniqueSemanticExpression pInfinitiveSemExp,
+                                UniqueSemanticExpression pResourceSemExp) {
+    Record record{RecordType::BEHAVIOR, {}, {}};
+    record.semExps.emplace_back(std::move(pInfinitiveSemExp));
+    record.semExps.emplace_back(std::move(pResourceSemExp));
+    _add(std::move(record));
+}
+
+
+void MemoryJournal::addCurrentUserId(const std::string &pUserId) {
+    _add(Record{RecordType::CURRENT_USER_ID, {}, pUserId});
+}
+
+
+void MemoryJournal::requestCompaction() {
+    bool wakeUp = false;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        wakeUp = _nbOfChangesSinceCompaction == 0;
+        _compactionRequested = true;
+        _addChange();
+    }
+    // The thread has to wait for the end of the compaction interval
+    if (wakeUp)
+        _wakeUp.notify_one();
+}
+
+
+void MemoryJournal::requestImmediateCompaction() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _immediateCompactionRequested = true;
+        _addChange();
+    }
+    _wakeUp.notify_one();
+}
+
+
+void MemoryJournal::_addChange() {
+    if (_nbOfChangesSinceCompaction++ == 0)
+        _firstChangeSinceCompaction = std::chrono::steady_clock::now();
+}
+
+
+void MemoryJournal::_add(Record pRecord) {
+    bool wakeUp = false;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _records.emplace_back(std::move(pRecord));
+        _addChange();
+        // The first record starts a batch, a full batch is written without waiting for the batch delay
+        wakeUp = _records.size() == 1 || _records.size() >= _maxBatchSize;
+    }
+    if (wakeUp)
+        _wakeUp.notify_one();
+}
+
+
+void MemoryJournal::_run() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (!_stopped) {
+        if (_records.empty()) {
+            auto hasSomethingToDo = [this]() {
+                return _stopped || _immediateCompactionRequested || !_records.empty();
+            };
+            if (_nbOfChangesSinceCompaction > 0)
+                _wakeUp.wait_until(lock, _firstChangeSinceCompaction + _compactionInterval, hasSomethingToDo);
+            else
+                _wakeUp.wait(lock, [&]() { return hasSomethingToDo() || _nbOfChangesSinceCompaction > 0; });
+        } else {
+            // Wait for the other records of the batch
+            _wakeUp.wait_for(lock, _batchDelay, [this]() {
+                return _stopped || _immediateCompactionRequested || _records.size() >= _maxBatchSize;
+            });
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (!_stopped &&
+            (_immediateCompactionRequested ||
+             (_nbOfChangesSinceCompaction > 0 && now - _firstChangeSinceCompaction >= _compactionInterval))) {
+            lock.unlock();
+            try {
+                _compact();
+            } catch (const std::exception &e) {
+                // The records stay in the queue, so they are written in the current journal
+                std::cout << "compaction of the journal " << _journalFilename << " failed: " << e.what() << std::endl;
+                // Retry after a compaction interval, instead of retrying in a loop
+                lock.lock();
+                _compactionRequested = _compactionRequested || _immediateCompactionRequested;
+                _immediateCompactionRequested = false;
+                _firstChangeSinceCompaction = now;
+                lock.unlock();
+            }
+            lock.lock();
+        }
+
+        if (!_records.empty()) {
+            auto records = std::move(_records);
+            _records.clear();
+            lock.unlock();
+            try {
+                _writeRecords(records);
+            } catch (const std::exception &e) {
+                std::cout << "writing of the journal " << _journalFilename << " failed: " << e.what() << std::endl;
+            }
+            records.clear();
+            lock.lock();
+        }
+    }
+
+    // The modifications that are not in the journal would be lost without a last snapshot
+    if (_immediateCompactionRequested || _compactionRequested) {
+        lock.unlock();
+        try {
+            _compact();
+        } catch (const std::exception &e) {
+            std::cout << "compaction of the journal " << _journalFilename << " failed: " << e.what() << std::endl;
+        }
+        lock.lock();
+    }
+    // The journal can be stopped before the first iteration of the loop
+    if (!_records.empty()) {
+        try {
+            _writeRecords(_records);
+        } catch (const std::exception &e) {
+            std::cout << "writing of the journal " << _journalFilename << " failed: " << e.what() << std::endl;
+        }
+        _records.clear();
+    }
+}
+
+
+void MemoryJournal::_writeRecords(const std::vector<Record> &pRecords) {
+    for (const auto &currRecord : pRecords) {
+        std::ostringstream recordOut;
+        binaryfile::writeUint32(recordOut, static_cast<std::uint32_t>(currRecord.type));
+        binaryfile::writeUint32(recordOut, static_cast<std::uint32_t>(currRecord.semExps.size()));
+        for (const auto &currSemExp : currRecord.semExps)
+            binaryfile::writeString(recordOut, semExpToString(*currSemExp));
+        binaryfile::writeString(recordOut, currRecord.text);
+        // The size prefix allows to detect a record that was not entirely written
+        binaryfile::writeString(_journalFile, recordOut.str());
+    }
+    _journalFile.flush();
+    if (!_journalFile)
+        throw std::runtime_error("cannot write in " + _journalFilename);
+}
+
+
+void MemoryJournal::_compact() {
+    MemorySnapshot snapshot;
+    std::size_t nbOfRecordsInTheSnapshot = 0;
+    std::size_t nbOfChangesInTheSnapshot = 0;
+    {
+        // The records and the compaction requests are added while the memory is locked for writing,
+        // so the changes of the queue are exactly the operations that are in the snapshot
+        std::shared_lock<std::shared_mutex> memoryLock(_memoryMutex);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            nbOfRecordsInTheSnapshot = _records.size();
+            nbOfChangesInTheSnapshot = _nbOfChangesSinceCompaction;
+        }
+        snapshot = makeMemorySnapshot(_semMemory, _generation + 1);
+    }
+    writeMemorySnapshot(_snapshotFilename, snapshot);
+    ++_generation;
+    _resetJournalFile();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _records.erase(_records.begin(), _records.begin() + nbOfRecordsInTheSnapshot);
+    _nbOfChangesSinceCompaction -= nbOfChangesInTheSnapshot;
+    if (_nbOfChangesSinceCompaction == 0) {
+        _immediateCompactionRequested = false;
+        _compactionRequested = false;
+    } else {
+        _firstChangeSinceCompaction = std::chrono::steady_clock::now();
+    }
+}
+
+
+void MemoryJournal::_resetJournalFile() {
+    _journalFile.close();
+    binaryfile::writeFileAtomically(_journalFilename, [this](std::ostream &pOut) {
+        pOut.write(_magic, sizeof(_magic));
+        binaryfile::writeUint32(pOut, _formatVersion);
+        binaryfile::writeUint32(pOut, _generation);
+    });
+    _journalFile.open(_journalFilename, std::ios::binary | std::ios::app);
+}
\ No newline at end of file
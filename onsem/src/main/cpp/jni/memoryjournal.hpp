@@ -0,0 +1,135 @@
+#ifndef SEMANTIC_ANDROID_MEMORYJOURNAL_HPP
+#define SEMANTIC_ANDROID_MEMORYJOURNAL_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <onsem/texttosemantic/dbtype/semanticexpression/semanticexpression.hpp>
+
+namespace onsem {
+    namespace linguistics {
+        struct LinguisticDatabase;
+    }
+    struct SemanticMemory;
+}
+
+
+/**
+ * Journal of the operations that modify a semantic memory, so that the memory can be restored
+ * after a crash without writing all its content at each modification.
+ *
+ * The operations only copy their input in a queue, a thread of the journal serializes and appends them
+ * to the journal file by batches.
+ * This thread also writes a snapshot of the memory and empties the journal (compaction) one compaction
+ * interval after the first modification that is not in a snapshot, so the time to restore the memory
+ * is bounded by the compaction interval, and a memory that is modified by bursts is not rewritten
+ * at the first modification after a long idle period.
+ * The operations that cannot be recorded in the journal (e.g. a reaction) request a compaction instead.
+ *
+ * The journal and the snapshot have a generation number, the journal is only replayed on the snapshot
+ * of the same generation. So a crash between the writing of a snapshot and the emptying of the journal
+ * does not replay twice the operations.
+ *
+ * The records have to be added while the memory is locked for writing, in the order of the operations,
+ * and only after the success of their operation.
+ */
+class MemoryJournal {
+public:
+    /// Restore a memory from its snapshot and its journal. (the files that do not exist are ignored)
+    /// @return The generation of the restored snapshot.
+    static std::uint32_t restore(const std::string &pSnapshotFilename,
+                                 const std::string &pJournalFilename,
+                                 onsem::SemanticMemory &pSemMemory,
+                                 const onsem::linguistics::LinguisticDatabase &pLingDb);
+
+    /**
+     * Start to write the journal of a memory that was just restored by the function restore.
+     * @param pMemoryMutex Mutex of the memory, locked in read mode by the compaction.
+     */
+    MemoryJournal(std::string pSnapshotFilename,
+                  std::string pJournalFilename,
+                  std::uint32_t pGeneration,
+                  std::chrono::milliseconds pCompactionInterval,
+                  std::shared_mutex &pMemoryMutex,
+                  const onsem::SemanticMemory &pSemMemory);
+    /// Write the records that are still in the queue, and a snapshot if an operation is not in the journal.
+    ~MemoryJournal();
+    MemoryJournal(const MemoryJournal &) = delete;
+    MemoryJournal &operator=(const MemoryJournal &) = delete;
+
+    void addInform(onsem::UniqueSemanticExpression pSemExp);
+    void addInformAxiom(onsem::UniqueSemanticExpression pSemExp);
+    void addTrigger(onsem::UniqueSemanticExpression pTriggerSemExp,
+                    onsem::UniqueSemanticExpression pAnswerSemExp);
+    void addBehavior(onsem::UniqueSemanticExpression pInfinitiveSemExp,
+                     onsem::UniqueSemanticExpression pResourceSemExp);
+    void addCurrentUserId(const std::string &pUserId);
+
+    /// Write a snapshot within the compaction interval, for the modifications that are not in the journal
+    /// (e.g. a reaction), so that the next records are not replayed on a memory without them.
+    void requestCompaction();
+
+    /// Write a snapshot as soon as possible, for the modifications that would be undone by the replay
+    /// of the previous records (e.g. a forget).
+    void requestImmediateCompaction();
+
+private:
+    enum class RecordType : std::uint32_t {
+        INFORM = 0,
+        INFORM_AXIOM = 1,
+        TRIGGER = 2,
+        BEHAVIOR = 3,
+        CURRENT_USER_ID = 4
+    };
+
+    struct Record {
+        RecordType type;
+        std::vector<onsem::UniqueSemanticExpression> semExps;
+        std::string text;
+    };
+
+    const std::string _snapshotFilename;
+    const std::string _journalFilename;
+    const std::chrono::milliseconds _compactionInterval;
+    std::shared_mutex &_memoryMutex;
+    const onsem::SemanticMemory &_semMemory;
+    /// Only used by the thread of the journal.
+    std::ofstream _journalFile;
+    std::uint32_t _generation;
+
+    /// Protect the members below.
+    std::mutex _mutex;
+    std::condition_variable _wakeUp;
+    bool _stopped;
+    bool _immediateCompactionRequested;
+    /// A modification that is not in the journal is waiting for the next snapshot.
+    bool _compactionRequested;
+    std::vector<Record> _records;
+    /// Number of records and of compaction requests since the last snapshot.
+    std::size_t _nbOfChangesSinceCompaction;
+    /// Time of the first change since the last snapshot, from which the compaction interval is counted.
+    std::chrono::steady_clock::time_point _firstChangeSinceCompaction;
+    std::thread _thread;
+
+    void _addChange();
+
+    void _add(Record pRecord);
+    void _run();
+    void _writeRecords(const std::vector<Record> &pRecords);
+    void _compact();
+    void _resetJournalFile();
+
+    static void _replay(const std::string &pJournalFilename,
+                        std::uint32_t pGeneration,
+                        onsem::SemanticMemory &pSemMemory,
+                        const onsem::linguistics::LinguisticDatabase &pLingDb);
+};
+
+
+#endif // SEMANTIC_ANDROID_MEMORYJOURNAL_HPP
@@ -0,0 +1,65 @@
+#include "memorysnapshot.hpp"
+#include <cstring>
+#include <fstream>
+#include <onsem/semantictotext/semanticmemory/semanticmemory.hpp>
+#include "semanticserialization.hpp"
+
+using namespace onsem;
+
+namespace {
+    constexpr char _magic[8] = {'O', 'N', 'S', 'E', 'M', 'M', 'E', 'M'};
+    /// The version 2 added the journal generation.
+    constexpr std::uint32_t _formatVersion = 2;
+}
+
+
+MemorySnapshot makeMemorySnapshot(const SemanticMemory &pSemMemory,
+                                  std::uint32_t pJournalGeneration) {
+    MemorySnapshot res;
+    res.defaultLanguage = pSemMemory.defaultLanguage;
+    res.currUserId = pSemMemory.getCurrUserId();
+    res.serializedSemMemory = semMemoryToString(pSemMemory);
+    res.journalGeneration = pJournalGeneration;
+    return res;
+}
+
+
+void writeMemorySnapshot(const std::string &pFilename, const MemorySnapshot &pSnapshot) {
+    binaryfile::writeFileAtomically(pFilename, [&](std::ostream &pOut) {
+        pOut.write(_magic, sizeof(_magic));
+        binaryfile::writeUint32(pOut, _formatVersion);
+        binaryfile::writeUint32(pOut, pSnapshot.journalGeneration);
+        binaryfile::writeUint32(pOut, static_cast<std::uint32_t>(pSnapshot.defaultLanguage));
+        binaryfile::writeString(pOut, pSnapshot.currUserId);
+        binaryfile::writeString(pOut, pSnapshot.serializedSemMemory);
+    });
+}
+
+
+MemorySnapshot readMemorySnapshot(const std::string &pFilename) {
+    std::ifstream in(pFilename, std::ios::binary);
+    if (!in)
+        throw std::runtime_error("cannot open the memory snapshot " + pFilename);
+    char magic[sizeof(_magic)];
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, _magic, sizeof(_magic)) != 0)
+        throw std::runtime_error(pFilename + " is not a memory snapshot");
+    auto formatVersion = binaryfile::readUint32(in);
+    if (formatVersion != 1 && formatVersion != _formatVersion)
+        throw std::runtime_error("unsupported version of memory snapshot: " + std::to_string(formatVersion));
+    MemorySnapshot res;
+    if (formatVersion >= 2)
+        res.journalGeneration = binaryfile::readUint32(in);
+    res.defaultLanguage = static_cast<SemanticLanguageEnum>(binaryfile::readUint32(in));
+    res.currUserId = binaryfile::readString(in);
+    res.serializedSemMemory = binaryfile::readString(in);
+    return res;
+}
+
+
+void restoreMemorySnapshot(const MemorySnapshot &pSnapshot,
+                           SemanticMemory &pSemMemory,
+                           const linguistics::LinguisticDatabase &pLingDb) {
+    stringToSemMemory(pSnapshot.serializedSemMemory, pSemMemory, pLingDb);
+    pSemMemory.defaultLanguage = pSnapshot.defaultLanguage;
+    pSemMemory.setCurrUserId(pSnapshot.currUserId);
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#ifndef SEMANTIC_ANDROID_MEMORYSNAPSHOT_HPP
+#define SEMANTIC_ANDROID_MEMORYSNAPSHOT_HPP
+
+#include <cstdint>
+#include <string>
+#include <onsem/common/enum/semanticlanguageenum.hpp>
+
+namespace onsem {
+    namespace linguistics {
+        struct LinguisticDatabase;
+    }
+    struct SemanticMemory;
+}
+
+
+/**
+ * Content of a semantic memory that can be written in a file, so that the memory can be restored
+ * without replaying all the operations that constructed it.
+ * The sub memory is not part of the snapshot, it has to be linked again after the restoration.
+ */
+struct MemorySnapshot {
+    onsem::SemanticLanguageEnum defaultLanguage = onsem::SemanticLanguageEnum::UNKNOWN;
+    std::string currUserId;
+    std::string serializedSemMemory;
+    /// Generation of the journal that continues this snapshot. (cf MemoryJournal)
+    std::uint32_t journalGeneration = 0;
+};
+
+/// The memory has to be locked during this call, but not during the writing of the snapshot.
+MemorySnapshot makeMemorySnapshot(const onsem::SemanticMemory &pSemMemory,
+                                  std::uint32_t pJournalGeneration = 0);
+
+/// The file is replaced atomically, so a crash during the writing keeps the previous snapshot.
+void writeMemorySnapshot(const std::string &pFilename, const MemorySnapshot &pSnapshot);
+
+MemorySnapshot readMemorySnapshot(const std::string &pFilename);
+
+/// Fill an empty semantic memory from a snapshot.
+void restoreMemorySnapshot(const MemorySnapshot &pSnapshot,
+                           onsem::SemanticMemory &pSemMemory,
+                           const onsem::linguistics::LinguisticDatabase &pLingDb);
+
+
+#endif // SEMANTIC_ANDROID_MEMORYSNAPSHOT_HPP
@@ -0,0 +1,201 @@
+#ifndef SEMANTIC_ANDROID_OBJECTREGISTRY_HPP
+#define SEMANTIC_ANDROID_OBJECTREGISTRY_HPP
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <jni.h>
+
+
+/**
+ * Registry of the C++ objects that are referenced from java by an id.
+ * The mutex of the registry is only held during the lookup of an id, and the lookups only share it,
+ * so the threads that use the same registry do not wait for each other.
+ * The objects are returned as shared pointers so that an object deleted from java
+ * while another thread is using it is only freed at the end of this other usage.
+ *
+ * It is a generational slot map, so the creation, the lookup and the deletion are in O(1).
+ * An id is composed of the index of a slot (low bits) and of the generation of this slot (high bits).
+ * The generation of a slot is incremented at each deletion, so an id that was deleted is detected
+ * as wrong instead of pointing to the new object stored in the same slot.
+ * A slot whose generation reaches the last one is retired instead of being reused, so an old id
+ * never points to a new object, whatever the number of reuses of its slot.
+ * (so the ids are only exhausted after about 2^31 deletions)
+ */
+template<typename T>
+class ObjectRegistry {
+public:
+    explicit ObjectRegistry(std::string pObjectName)
+            : _objectName(std::move(pObjectName)),
+              _mutex(),
+              _slots(),
+              _freeSlotIndexes(),
+              _size(0) {
+    }
+
+    jint add(std::shared_ptr<T> pObject) {
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+        std::uint32_t slotIndex = 0;
+        if (!_freeSlotIndexes.empty()) {
+            slotIndex = _freeSlotIndexes.front();
+            _freeSlotIndexes.pop_front();
+        } else {
+            if (_slots.size() >= _maxNbOfSlots) {
+                std::stringstream ssErrorMessage;
+                ssErrorMessage << "too many " << _objectName << " objects";
+                throw std::runtime_error(ssErrorMessage.str());
+            }
+            slotIndex = static_cast<std::uint32_t>(_slots.size());
+            _slots.emplace_back();
+        }
+        auto &slot = _slots[slotIndex];
+        slot.object = std::move(pObject);
+        ++_size;
+        return static_cast<jint>((slot.generation << _nbOfIndexBits) | (slotIndex + 1));
+    }
+
+    /// Get an object, throw if the id is unknown.
+    std::shared_ptr<T> get(jint pId) const {
+        auto res = find(pId);
+        if (!res) {
+            std::stringstream ssErrorMessage;
+            ssErrorMessage << "wrong " << _objectName << " id: " << pId;
+            throw std::runtime_error(ssErrorMessage.str());
+        }
+        return res;
+    }
+
+    /// Get an object, return nullptr if the id is unknown.
+    std::shared_ptr<T> find(jint pId) const {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        if (!_isValidId(pId))
+            return {};
+        return _slots[_idToSlotIndex(pId)].object;
+    }
+
+    /**
+     * Remove an object from the registry.
+     * The removed object is returned so that its destruction happens outside of the registry mutex.
+     */
+    std::shared_ptr<T> remove(jint pId) {
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+        if (!_isValidId(pId))
+            return {};
+        auto slotIndex = _idToSlotIndex(pId);
+        auto &slot = _slots[slotIndex];
+        auto res = std::move(slot.object);
+        slot.object.reset();
+        if (slot.generation < _generationMask) {
+            ++slot.generation;
+            _freeSlotIndexes.push_back(slotIndex);
+        }
+        --_size;
+        return res;
+    }
+
+    std::size_t size() const {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        return _size;
+    }
+
+private:
+    struct Slot {
+        std::uint32_t generation = 0;
+        std::shared_ptr<T> object;
+    };
+
+    /// 20 bits for the index and 11 bits for the generation, so that the ids are always strictly positive.
+    static constexpr std::uint32_t _nbOfIndexBits = 20;
+    static constexpr std::uint32_t _indexMask = (1u << _nbOfIndexBits) - 1;
+    static constexpr std::uint32_t _generationMask = (1u << (31 - _nbOfIndexBits)) - 1;
+    static constexpr std::size_t _maxNbOfSlots = _indexMask;
+
+    const std::string _objectName;
+    mutable std::shared_mutex _mutex;
+    std::vector<Slot> _slots;
+    std::deque<std::uint32_t> _freeSlotIndexes;
+    std::size_t _size;
+
+    static std::uint32_t _idToSlotIndex(jint pId) {
+        return (static_cast<std::uint32_t>(pId) & _indexMask) - 1;
+    }
+
+    bool _isValidId(jint pId) const {
+        if (pId <= 0)
+            return false;
+        auto slotIndex = _idToSlotIndex(pId);
+        if (slotIndex >= _slots.size())
+            return false;
+        const auto &slot = _slots[slotIndex];
+        return slot.object && slot.generation == (static_cast<std::uint32_t>(pId) >> _nbOfIndexBits);
+    }
+};
+
+
+/**
+ * Object that is modified through the JNI with its own reader/writer lock.
+ * (the ORDER of the members is important, the mutex is destroyed after the object,
+ * so the destructor of the object can still lock it, e.g. to stop the thread of a memory journal)
+ */
+template<typename T>
+struct LockableObject {
+    template<typename... ARGS>
+    explicit LockableObject(ARGS &&... pArgs)
+            : mutex(),
+              object(std::forward<ARGS>(pArgs)...) {
+    }
+
+    mutable std::shared_mutex mutex;
+    T object;
+};
+
+
+/**
+ * Keep an object alive and hold a shared lock on it during the life of this object.
+ * (the ORDER of the members is important, the lock is released before the object)
+ */
+template<typename T>
+class ReadLockedObject {
+public:
+    explicit ReadLockedObject(std::shared_ptr<LockableObject<T>> pObject)
+            : _object(std::move(pObject)),
+              _lock(_object->mutex) {
+    }
+
+    const T &operator*() const { return _object->object; }
+    const T *operator->() const { return &_object->object; }
+
+private:
+    std::shared_ptr<LockableObject<T>> _object;
+    std::shared_lock<std::shared_mutex> _lock;
+};
+
+
+/**
+ * Keep an object alive and hold an exclusive lock on it during the life of this object.
+ * (the ORDER of the members is important, the lock is released before the object)
+ */
+template<typename T>
+class WriteLockedObject {
+public:
+    explicit WriteLockedObject(std::shared_ptr<LockableObject<T>> pObject)
+            : _object(std::move(pObject)),
+              _lock(_object->mutex) {
+    }
+
+    T &operator*() const { return _object->object; }
+    T *operator->() const { return &_object->object; }
+
+private:
+    std::shared_ptr<LockableObject<T>> _object;
+    std::unique_lock<std::shared_mutex> _lock;
+};
+
+
+#endif // SEMANTIC_ANDROID_OBJECTREGISTRY_HPP
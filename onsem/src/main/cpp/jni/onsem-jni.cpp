@@ -1,5 +1,6 @@
 #include "onsem-jni.h"
 #include "jobjectstocpptypes.hpp"
+#include <cstdint>
 #include <regex>
 #include <iostream>
 #include <sstream>
@@ -7,6 +8,7 @@
 #include <map>
 #include <set>
 #include <memory>
+#include <vector>
 #include <jni.h>
 #include <onsem/common/keytostreams.hpp>
 #include <onsem/texttosemantic/dbtype/linguisticdatabase.hpp>
@@ -21,7 +23,6 @@
 #include <onsem/semantictotext/semanticconverter.hpp>
 #include <onsem/semantictotext/semexpoperators.hpp>
 #include <onsem/semantictotext/triggers.hpp>
-#include <onsem/texttosemantic/languagedetector.hpp>
 #include <onsem/semantictotext/outputter/outputtercontext.hpp>
 #include <onsem/semantictotext/outputter/executiondataoutputter.hpp>
 #include <onsem/texttosemantic/tool/semexpgetter.hpp>
@@ -31,37 +32,57 @@
 #include "linguisticdatabase-jni.hpp"
 #include "semanticmemory-jni.hpp"
 #include "semanticexpression-jni.hpp"
+#include "objectregistry.hpp"
+#include "javabindings.hpp"
+#include "memoryjournal.hpp"
+#include "semanticserialization.hpp"
+#include "synthesiscache.hpp"
+#include "languageidentifier.hpp"
+#include "paralleltasks.hpp"
 
 using namespace onsem;
 
 
 namespace {
-    /// Any JNI function that will deal with references maintained across the JNI should lock this mutex.
-    std::mutex _jniReferencesMutex;
-    std::map<jint, std::shared_ptr<ExpressionWithLinks>> _idToExpWrapperForMemory;
-
-
+    ObjectRegistry<ExpressionWithLinks> _idToExpWrapperForMemory("expression wrapper for memory");
+
+
+    /**
+     * Outputter that encodes the execution events in a binary buffer.
+     * The buffer is decoded by JiniOutputter.decodeExecutionEvents on the java side,
+     * so a reaction only needs one call to java instead of one call per event.
+     * Format (native byte order):
+     *   each event is its type on 1 byte followed by its content,
+     *   an int is 4 bytes, a string is its length in bytes (an int) followed by its UTF-8 bytes.
+     * (keep it in sync with JiniOutputter.kt)
+     */
     struct JiniOutputter : public ExecutionDataOutputter {
         JiniOutputter(SemanticMemory &pSemanticMemory,
                       const linguistics::LinguisticDatabase &pLingDb,
-                      JNIEnv *env,
-                      jobject jOutputter,
                       bool pInformAboutWhatWasDone)
                 : ExecutionDataOutputter(pSemanticMemory, pLingDb),
-                  _env(env),
-                  _jiniOutputterClass(env->FindClass("com/onsem/JiniOutputter")),
-                  _jOutputter(jOutputter),
+                  events(),
                   _informAboutWhatWasDone(pInformAboutWhatWasDone) {
         }
 
         ~JiniOutputter() override = default;
 
+        enum class EventType : std::uint8_t {
+            TEXT = 0,
+            RESOURCE = 1,
+            BEGIN_OF_SCOPE = 2,
+            END_OF_SCOPE = 3,
+            RESOURCE_NB_OF_TIMES = 4,
+            INSIDE_SCOPE_NB_OF_TIMES = 5
+        };
+
+        std::string events;
+
         void _exposeText(const std::string& pText,
                          SemanticLanguageEnum pLanguage) override
         {
-            jmethodID exposeTextFun = _env->GetMethodID(_jiniOutputterClass, "exposeText",
-                                                        "(Ljava/lang/String;)V");
-            _env->CallVoidMethod(_jOutputter, exposeTextFun, _env->NewStringUTF(pText.c_str()));
+            _writeEventType(EventType::TEXT);
+            _writeString(pText);
             if (_informAboutWhatWasDone)
                 ExecutionDataOutputter::_exposeText(pText, pLanguage);
         }
@@ -69,90 +90,176 @@ namespace {
         void _exposeResource(const SemanticResource& pResource,
                              const std::map<std::string, std::vector<std::string>>& pParameters) override
         {
-            jmethodID exposeResourceFun = _env->GetMethodID(_jiniOutputterClass, "exposeResource",
-                                                            "(Ljava/lang/String;Ljava/lang/String;Ljava/util/Map;)V");
-            _env->CallVoidMethod(_jOutputter, exposeResourceFun,
-                                 _env->NewStringUTF(pResource.label.c_str()),
-                                 _env->NewStringUTF(pResource.value.c_str()),
-                                 stlStringVectorStringMapToJavaHashMap(_env, pParameters));
+            _writeEventType(EventType::RESOURCE);
+            _writeString(pResource.label);
+            _writeString(pResource.value);
+            _writeInt(pParameters.size());
+            for (const auto &currParameter : pParameters) {
+                _writeString(currParameter.first);
+                _writeInt(currParameter.second.size());
+                for (const auto &currValue : currParameter.second)
+                    _writeString(currValue);
+            }
             if (_informAboutWhatWasDone)
                 ExecutionDataOutputter::_exposeResource(pResource, pParameters);
         }
 
         void _beginOfScope(Link pLink) override
         {
-            jmethodID beginOfScopeFun = _env->GetMethodID(_jiniOutputterClass, "beginOfScope",
-                                                          "(Ljava/lang/String;)V");
-
-            std::string linkStr;
+            // Same order as JiniOutputter.Link
+            std::uint8_t linkIndex = 0;
             switch (pLink)
             {
                 case onsem::VirtualOutputter::Link::AND:
-                    linkStr = "AND";
+                    linkIndex = 0;
                     break;
                 case onsem::VirtualOutputter::Link::THEN:
-                    linkStr = "THEN";
+                    linkIndex = 1;
                     break;
                 case onsem::VirtualOutputter::Link::THEN_REVERSED:
-                    linkStr = "THEN_REVERSED";
+                    linkIndex = 2;
                     break;
                 case onsem::VirtualOutputter::Link::IN_BACKGROUND:
-                    linkStr = "IN_BACKGROUND";
+                    linkIndex = 3;
                     break;
             }
-            _env->CallVoidMethod(_jOutputter, beginOfScopeFun,
-                                 _env->NewStringUTF(linkStr.c_str()));
+            _writeEventType(EventType::BEGIN_OF_SCOPE);
+            events.push_back(static_cast<char>(linkIndex));
         }
 
         void _endOfScope() override
         {
-            jmethodID endOfScopeFun = _env->GetMethodID(_jiniOutputterClass, "endOfScope",
-                                                        "()V");
-            _env->CallVoidMethod(_jOutputter, endOfScopeFun);
+            _writeEventType(EventType::END_OF_SCOPE);
         }
 
         void _resourceNbOfTimes(int pNumberOfTimes) override
         {
-            jmethodID resourceNbOfTimesFun = _env->GetMethodID(_jiniOutputterClass, "resourceNbOfTimes",
-                                                               "(I)V");
-            _env->CallVoidMethod(_jOutputter, resourceNbOfTimesFun, pNumberOfTimes);
+            _writeEventType(EventType::RESOURCE_NB_OF_TIMES);
+            _writeInt(pNumberOfTimes);
         }
 
         void _insideScopeNbOfTimes(int pNumberOfTimes) override
         {
-            jmethodID insideScopeNbOfTimesFun = _env->GetMethodID(_jiniOutputterClass, "insideScopeNbOfTimes",
-                                                                  "(I)V");
-            _env->CallVoidMethod(_jOutputter, insideScopeNbOfTimesFun, pNumberOfTimes);
+            _writeEventType(EventType::INSIDE_SCOPE_NB_OF_TIMES);
+            _writeInt(pNumberOfTimes);
         }
 
 
     private:
-        JNIEnv *_env;
-        jclass _jiniOutputterClass;
-        jobject _jOutputter;
         bool _informAboutWhatWasDone;
+
+        void _writeEventType(EventType pEventType) {
+            events.push_back(static_cast<char>(pEventType));
+        }
+
+        void _writeInt(std::size_t pValue) {
+            auto value = static_cast<std::int32_t>(pValue);
+            events.append(reinterpret_cast<const char *>(&value), sizeof(value));
+        }
+
+        void _writeString(const std::string &pStr) {
+            _writeInt(pStr.size());
+            events.append(pStr);
+        }
     };
 
+
+    jobject _informAxiom(JNIEnv *env,
+                         UniqueSemanticExpression pSemExp,
+                         jobject pSemanticMemoryJObj,
+                         jobject pLinguisticDatabaseJObj) {
+        auto lingDbPtr = getLingDb(env, pLinguisticDatabaseJObj);
+        auto &lingDb = *lingDbPtr;
+        auto lockedSemanticMemory = writeSemanticMemory(env, pSemanticMemoryJObj);
+        auto &semanticMemory = *lockedSemanticMemory;
+        auto *journal = lockedSemanticMemory.journal();
+        if (journal == nullptr)
+            return newExpressionWithLinks(
+                    env,
+                    memoryOperation::informAxiom(
+                            std::move(pSemExp),
+                            semanticMemory, lingDb));
+        // Only the operations that succeeded are journaled
+        auto expressionWithLinks = memoryOperation::informAxiom(pSemExp->clone(), semanticMemory, lingDb);
+        journal->addInformAxiom(std::move(pSemExp));
+        return newExpressionWithLinks(env, std::move(expressionWithLinks));
+    }
+
+
+    jobject _answer(JNIEnv *env,
+                    UniqueSemanticExpression pSemExp,
+                    jobject pSemanticMemoryJObj,
+                    jobject pLinguisticDatabaseJObj) {
+        auto lingDbPtr = getLingDb(env, pLinguisticDatabaseJObj);
+        auto &lingDb = *lingDbPtr;
+        auto lockedSemanticMemory = readSemanticMemory(env, pSemanticMemoryJObj);
+        auto &semanticMemory = *lockedSemanticMemory;
+        return semanticExpressionPtrToJobject(env, memoryOperation::answer(std::move(pSemExp), false,
+                                                                           semanticMemory, lingDb));
+    }
+
+
+    /// The language of a locale, "un" for the unknown and the unsupported languages.
+    const char *_languageToLocaleStr(SemanticLanguageEnum pLanguage) {
+        switch (pLanguage) {
+            case SemanticLanguageEnum::FRENCH:
+                return "fr";
+            case SemanticLanguageEnum::ENGLISH:
+                return "en";
+            case SemanticLanguageEnum::JAPANESE:
+                return "ja";
+            default:
+                return "un";
+        }
+    }
 }
 
 
 void runOutputter(
         JNIEnv *env,
         SemanticLanguageEnum pLanguage,
-        SemanticMemory& pSemMemory,
+        const WriteLockedSemanticMemory& pLockedSemMemory,
         linguistics::LinguisticDatabase& pLingDb,
         const SemanticExpression& pSemExp,
         jobject jOutputter,
         bool pInformAboutWhatWasDone,
         const SemanticExpression* pInputSemExpPtr) {
-    auto outContext = TextProcessingContext::getTextProcessingContextFromRobot(pLanguage);
-    OutputterContext outputterContext(outContext);
-    outputterContext.inputSemExpPtr = pInputSemExpPtr;
-    std::string answer;
-    JiniOutputter outputter(pSemMemory, pLingDb, env, jOutputter, pInformAboutWhatWasDone);
-    outputter.processSemExp(pSemExp, outputterContext);
+    auto &semMemory = *pLockedSemMemory;
+    // The events do not depend on the memory only if the outputter does not inform the memory
+    auto *synthesisCache = pInformAboutWhatWasDone ? nullptr : pLockedSemMemory.synthesisCache();
+    std::string synthesisCacheKey;
+    std::string events;
+    bool eventsAreCached = false;
+    if (synthesisCache != nullptr) {
+        // The input expression is in the key because the parameters of the resources are extracted from it
+        synthesisCacheKey = "outputter\n" + semanticLanguageEnum_toLegacyStr(pLanguage) + '\n' +
+                            std::to_string(semExpStructuralHash(pSemExp)) + '\n' +
+                            (pInputSemExpPtr != nullptr ?
+                             std::to_string(semExpStructuralHash(*pInputSemExpPtr)) : std::string());
+        eventsAreCached = synthesisCache->get(synthesisCacheKey, pLockedSemMemory.knowledgeGeneration(), events);
+    }
+
+    JiniOutputter outputter(semMemory, pLingDb, pInformAboutWhatWasDone);
+    if (!eventsAreCached) {
+        auto outContext = TextProcessingContext::getTextProcessingContextFromRobot(pLanguage);
+        OutputterContext outputterContext(outContext);
+        outputterContext.inputSemExpPtr = pInputSemExpPtr;
+        outputter.processSemExp(pSemExp, outputterContext);
+        events = std::move(outputter.events);
+        if (synthesisCache != nullptr)
+            synthesisCache->put(synthesisCacheKey, pLockedSemMemory.knowledgeGeneration(), events);
+    }
+    if (!events.empty()) {
+        // The java side decodes the buffer during the call, so it can point to the memory of this function
+        jobject eventsBuffer = env->NewDirectByteBuffer(&events[0], events.size());
+        env->CallVoidMethod(jOutputter, getJavaBindings().jiniOutputterDecodeExecutionEventsMethod,
+                            eventsBuffer);
+        env->DeleteLocalRef(eventsBuffer);
+        if (env->ExceptionCheck())
+            return;
+    }
     if (pInformAboutWhatWasDone)
-        outputter.rootExecutionData.run(pSemMemory, pLingDb);
+        outputter.rootExecutionData.run(semMemory, pLingDb);
 }
 
 
@@ -161,53 +268,41 @@ convertCppExceptionsToJavaExceptions(JNIEnv *env, const std::function<void()> &p
     try {
         pFunction();
     } catch (const std::exception &e) {
-        env->ThrowNew(env->FindClass("java/lang/RuntimeException"), e.what());
+        env->ThrowNew(getJavaBindings().runtimeExceptionClass, e.what());
     }
 }
 
-void protectByMutex(const std::function<void()> &pFunction) {
-    std::lock_guard<std::mutex> lock(_jniReferencesMutex);
-    pFunction();
-}
-
-template<typename T>
-T protectByMutexWithReturn(const std::function<T()> &pFunction) {
-    std::lock_guard<std::mutex> lock(_jniReferencesMutex);
-    return pFunction();
-}
-
-
-template jobject protectByMutexWithReturn<jobject>(const std::function<jobject()> &pFunction);
-
-template jstring protectByMutexWithReturn<jstring>(const std::function<jstring()> &pFunction);
-
-template jint protectByMutexWithReturn<jint>(const std::function<jint()> &pFunction);
-
-template jobjectArray protectByMutexWithReturn<jobjectArray>(const std::function<jobjectArray()> &pFunction);
-
 
 jobject newExpressionWithLinks(
         JNIEnv *env,
         const std::shared_ptr<ExpressionWithLinks> &pExp) {
     if (!pExp)
         throw std::runtime_error("the ExpressionWrapperForMemory is empty");
-    jint newKey = findMissingKey(_idToExpWrapperForMemory);
-    _idToExpWrapperForMemory.emplace(newKey, pExp);
-    jclass expressionWrapperForMemoryClass = env->FindClass(
-            "com/onsem/ExpressionWithLinks");
-    jmethodID expressionWrapperForMemoryConstructor =
-            env->GetMethodID(expressionWrapperForMemoryClass, "<init>", "(I)V");
-    return env->NewObject(expressionWrapperForMemoryClass, expressionWrapperForMemoryConstructor,
+    jint newKey = _idToExpWrapperForMemory.add(pExp);
+    const auto &javaBindings = getJavaBindings();
+    return env->NewObject(javaBindings.expressionWithLinksClass, javaBindings.expressionWithLinksConstructor,
                           newKey);
 }
 
 
-jint JNI_OnLoad(JavaVM* /*vm*/, void* /*reserved*/) {
+jint JNI_OnLoad(JavaVM* vm, void* /*reserved*/) {
 #ifdef COUT_TO_ANDROID_LOG
     // Also initialize the forwarding of logs to Android.
     std::cout.rdbuf(new forward_to_android);
     // TODO: write this in a way that does not leak and does not conflict with other libraries
 #endif // COUT_TO_ANDROID_LOG
+    JNIEnv *env = nullptr;
+    if (vm->GetEnv(reinterpret_cast<void **>(&env), JNI_VERSION_1_6) != JNI_OK)
+        return JNI_ERR;
+    // Resolve the java classes here because it is the only place where FindClass is sure to use the
+    // class loader of the application, and because the result is then shared by all the threads.
+    try {
+        initJavaBindings(env);
+        initSemanticEnumsIndexes(env);
+    } catch (const std::exception &e) {
+        std::cout << "onsem JNI_OnLoad failed: " << e.what() << std::endl;
+        return JNI_ERR;
+    }
     return JNI_VERSION_1_6;
 }
 
@@ -217,11 +312,8 @@ JNIEXPORT void JNICALL
 Java_com_onsem_OnsemKt_deleteExpressionWithLinks(
         JNIEnv *env, jclass /*clazz*/, jint expressionWrapperForMemoryId) {
     convertCppExceptionsToJavaExceptions(env, [&]() {
-        std::lock_guard<std::mutex> lock(_jniReferencesMutex);
-        auto it = _idToExpWrapperForMemory.find(expressionWrapperForMemoryId);
         // The object can be already deleted if it was used to uninform (because after that call the object is not usable anymore)
-        if (it != _idToExpWrapperForMemory.end())
-            _idToExpWrapperForMemory.erase(it);
+        _idToExpWrapperForMemory.remove(expressionWrapperForMemoryId);
     });
 }
 
@@ -231,9 +323,9 @@ JNIEXPORT jboolean JNICALL
 Java_com_onsem_OnsemKt_isAProperNoun(
         JNIEnv *env, jclass /*clazz*/, jstring jtext, jint linguisticDatabaseId) {
     return convertCppExceptionsToJavaExceptionsAndReturnTheResult<jboolean>(env, [&]() {
-        std::lock_guard<std::mutex> lock(_jniReferencesMutex);
         auto text = toString(env, jtext);
-        auto &lingDb = getLingDb(linguisticDatabaseId);
+        auto lingDbPtr = getLingDb(linguisticDatabaseId);
+        auto &lingDb = *lingDbPtr;
         return linguistics::isAProperNoun(text, lingDb);
     }, false);
 }
@@ -250,26 +342,30 @@ Java_com_onsem_OnsemKt_inform(
         jobject jOutputter,
         jboolean informAboutWhatWasDone) {
     return convertCppExceptionsToJavaExceptionsAndReturnTheResult<jobject>(env, [&]() {
-        std::lock_guard<std::mutex> lock(_jniReferencesMutex);
-        auto &lingDb = getLingDb(env, linguisticDatabaseJObj);
-        auto &semanticMemory = getSemanticMemory(env, semanticMemoryJObj);
-        auto &semExp = getSemExp(env, semanticExpressionJObj);
+        auto language = toLanguage(env, locale);
+        auto lingDbPtr = getLingDb(env, linguisticDatabaseJObj, language);
+        auto &lingDb = *lingDbPtr;
+        auto semExpPtr = getSemExp(env, semanticExpressionJObj);
+        auto &semExp = *semExpPtr;
+        auto lockedSemanticMemory = writeSemanticMemory(env, semanticMemoryJObj);
+        auto &semanticMemory = *lockedSemanticMemory;
 
         std::list<UniqueSemanticExpression> reactions;
         auto connection = semanticMemory.memBloc.actionProposalSignal.connectUnsafe([&](UniqueSemanticExpression& pUSemExp) {
             reactions.emplace_back(pUSemExp->clone());
         });
 
-        auto res = newExpressionWithLinks(
-                env,
-                memoryOperation::inform(
-                        semExp->clone(),
-                        semanticMemory, lingDb));
+        auto expressionWithLinks = memoryOperation::inform(
+                semExp->clone(),
+                semanticMemory, lingDb);
+        // Only the operations that succeeded are journaled
+        if (auto *journal = lockedSemanticMemory.journal())
+            journal->addInform(semExp->clone());
+        auto res = newExpressionWithLinks(env, std::move(expressionWithLinks));
 
         semanticMemory.memBloc.actionProposalSignal.disconnectUnsafe(connection);
         for (auto& currReaction : reactions) {
-            auto language = toLanguage(env, locale);
-            runOutputter(env, language, semanticMemory, lingDb, *currReaction, jOutputter,
+            runOutputter(env, language, lockedSemanticMemory, lingDb, *currReaction, jOutputter,
                          informAboutWhatWasDone, &*semExp);
         }
         return res;
@@ -285,15 +381,22 @@ Java_com_onsem_OnsemKt_informAxiom(
         jobject semanticMemoryJObj,
         jobject linguisticDatabaseJObj) {
     return convertCppExceptionsToJavaExceptionsAndReturnTheResult<jobject>(env, [&]() {
-        std::lock_guard<std::mutex> lock(_jniReferencesMutex);
-        auto &lingDb = getLingDb(env, linguisticDatabaseJObj);
-        auto &semanticMemory = getSemanticMemory(env, semanticMemoryJObj);
-        auto &semExp = getSemExp(env, semanticExpressionJObj);
-        return newExpressionWithLinks(
-                env,
-                memoryOperation::informAxiom(
-                        semExp->clone(),
-                        semanticMemory, lingDb));
+        auto semExpPtr = getSemExp(env, semanticExpressionJObj);
+        return _informAxiom(env, (*semExpPtr)->clone(), semanticMemoryJObj, linguisticDatabaseJObj);
+    }, nullptr);
+}
+
+
+extern "C"
+JNIEXPORT jobject JNICALL
+Java_com_onsem_OnsemKt_informAxiomAndConsumeCpp(
+        JNIEnv *env, jclass /*clazz*/,
+        jobject semanticExpressionJObj,
+        jobject semanticMemoryJObj,
+        jobject linguisticDatabaseJObj) {
+    return convertCppExceptionsToJavaExceptionsAndReturnTheResult<jobject>(env, [&]() {
+        return _informAxiom(env, takeSemExp(env, semanticExpressionJObj), semanticMemoryJObj,
+                            linguisticDatabaseJObj);
     }, nullptr);
 }
 
@@ -309,21 +412,26 @@ Java_com_onsem_OnsemKt_reactCpp(
         jobject jOutputter,
         jboolean informAboutWhatWasDone) {
     return convertCppExceptionsToJavaExceptionsAndReturnTheResult<jstring>(env, [&]() {
-        std::lock_guard<std::mutex> lock(_jniReferencesMutex);
-        auto &lingDb = getLingDb(env, linguisticDatabaseJObj);
-        auto &semanticMemory = getSemanticMemory(env, semanticMemoryJObj);
-        auto &semExp = getSemExp(env, semanticExpressionJObj);
+        auto language = toLanguage(env, locale);
+        auto lingDbPtr = getLingDb(env, linguisticDatabaseJObj, language);
+        auto &lingDb = *lingDbPtr;
+        auto semExpPtr = getSemExp(env, semanticExpressionJObj);
+        auto &semExp = *semExpPtr;
+        auto lockedSemanticMemory = writeSemanticMemory(env, semanticMemoryJObj);
+        auto &semanticMemory = *lockedSemanticMemory;
 
         mystd::unique_propagate_const<UniqueSemanticExpression> reaction;
+        // The outputter reads the input after the reaction, so a consuming variant would still need this copy
         memoryOperation::react(
                 reaction, semanticMemory, semExp->clone(),
                 lingDb);
+        // The reactions are not journaled
+        lockedSemanticMemory.requestCompaction();
 
         if (!reaction)
             return env->NewStringUTF("");
         auto reactionType = SemExpGetter::extractContextualAnnotation(**reaction);
-        auto language = toLanguage(env, locale);
-        runOutputter(env, language, semanticMemory, lingDb, **reaction, jOutputter,
+        runOutputter(env, language, lockedSemanticMemory, lingDb, **reaction, jOutputter,
                      informAboutWhatWasDone, &*semExp);
         return env->NewStringUTF(contextualAnnotation_toStr(reactionType).c_str());
     }, nullptr);
@@ -340,21 +448,25 @@ Java_com_onsem_OnsemKt_teachBehaviorCpp(
         jobject jOutputter,
         jboolean informAboutWhatWasDone) {
     return convertCppExceptionsToJavaExceptionsAndReturnTheResult<jstring>(env, [&]() {
-        std::lock_guard<std::mutex> lock(_jniReferencesMutex);
-        auto &lingDb = getLingDb(env, linguisticDatabaseJObj);
-        auto &semanticMemory = getSemanticMemory(env, semanticMemoryJObj);
-        auto &semExp = getSemExp(env, semanticExpressionJObj);
+        auto language = toLanguage(env, locale);
+        auto lingDbPtr = getLingDb(env, linguisticDatabaseJObj, language);
+        auto &lingDb = *lingDbPtr;
+        auto semExpPtr = getSemExp(env, semanticExpressionJObj);
+        auto &semExp = *semExpPtr;
+        auto lockedSemanticMemory = writeSemanticMemory(env, semanticMemoryJObj);
+        auto &semanticMemory = *lockedSemanticMemory;
 
         mystd::unique_propagate_const<UniqueSemanticExpression> reaction;
         memoryOperation::teach(
                 reaction, semanticMemory, semExp->clone(),
                 lingDb, memoryOperation::SemanticActionOperatorEnum::BEHAVIOR);
+        // The teachings are not journaled
+        lockedSemanticMemory.requestCompaction();
 
         if (!reaction)
             return env->NewStringUTF("");
         auto reactionType = SemExpGetter::extractContextualAnnotation(**reaction);
-        auto language = toLanguage(env, locale);
-        runOutputter(env, language, semanticMemory, lingDb, **reaction, jOutputter,
+        runOutputter(env, language, lockedSemanticMemory, lingDb, **reaction, jOutputter,
                      informAboutWhatWasDone, &*semExp);
         return env->NewStringUTF(contextualAnnotation_toStr(reactionType).c_str());
     }, nullptr);
@@ -372,10 +484,13 @@ Java_com_onsem_OnsemKt_callOperatorsCpp(
         jobject linguisticDatabaseJObj,
         jobject jOutputter) {
     return convertCppExceptionsToJavaExceptionsAndReturnTheResult<jstring>(env, [&]() {
-        std::lock_guard<std::mutex> lock(_jniReferencesMutex);
-        auto &lingDb = getLingDb(env, linguisticDatabaseJObj);
-        auto &semanticMemory = getSemanticMemory(env, semanticMemoryJObj);
-        auto &semExp = getSemExp(env, semanticExpressionJObj);
+        auto language = toLanguage(env, locale);
+        auto lingDbPtr = getLingDb(env, linguisticDatabaseJObj, language);
+        auto &lingDb = *lingDbPtr;
+        auto semExpPtr = getSemExp(env, semanticExpressionJObj);
+        auto &semExp = *semExpPtr;
+        auto lockedSemanticMemory = writeSemanticMemory(env, semanticMemoryJObj);
+        auto &semanticMemory = *lockedSemanticMemory;
 
         bool informAboutWhatWasDone = false;
         mystd::unique_propagate_const<UniqueSemanticExpression> reaction;
@@ -383,7 +498,7 @@ Java_com_onsem_OnsemKt_callOperatorsCpp(
         for (int i = 0; i < size; ++i) {
             auto operatorJObj = reinterpret_cast<jobject>(env->GetObjectArrayElement(
                     operatorsJObj, i));
-            auto javaOperatorEnum = toJavaOperatorEnum(env, operatorJObj, getSemanticEnumsIndexes(env));
+            auto javaOperatorEnum = toJavaOperatorEnum(env, operatorJObj, getSemanticEnumsIndexes());
             env->DeleteLocalRef(operatorJObj);
 
             switch (javaOperatorEnum)
@@ -427,12 +542,13 @@ Java_com_onsem_OnsemKt_callOperatorsCpp(
             if (reaction)
                 break;
         }
+        // The operators are not journaled
+        lockedSemanticMemory.requestCompaction();
 
         if (!reaction)
             return env->NewStringUTF("");
         auto reactionType = SemExpGetter::extractContextualAnnotation(**reaction);
-        auto language = toLanguage(env, locale);
-        runOutputter(env, language, semanticMemory, lingDb, **reaction, jOutputter,
+        runOutputter(env, language, lockedSemanticMemory, lingDb, **reaction, jOutputter,
                      informAboutWhatWasDone, &*semExp);
         return env->NewStringUTF(contextualAnnotation_toStr(reactionType).c_str());
     }, nullptr);
@@ -447,21 +563,26 @@ Java_com_onsem_OnsemKt_forget(
         jobject semanticMemoryJObj,
         jobject linguisticDatabaseJObj) {
     convertCppExceptionsToJavaExceptions(env, [&]() {
-        std::lock_guard<std::mutex> lock(_jniReferencesMutex);
         auto expressionWrapperForMemoryId = toDisposableWithIdId(env,
                                                                  expressionWrapperForMemoryJObj);
 
-        auto &lingDb = getLingDb(env, linguisticDatabaseJObj);
-        auto &semanticMemory = getSemanticMemory(env, semanticMemoryJObj);
-        auto it = _idToExpWrapperForMemory.find(expressionWrapperForMemoryId);
-        if (it == _idToExpWrapperForMemory.end()) {
+        auto lingDbPtr = getLingDb(env, linguisticDatabaseJObj);
+        auto &lingDb = *lingDbPtr;
+        auto lockedSemanticMemory = writeSemanticMemory(env, semanticMemoryJObj);
+        auto &semanticMemory = *lockedSemanticMemory;
+        auto expressionWrapperForMemory = _idToExpWrapperForMemory.find(expressionWrapperForMemoryId);
+        if (!expressionWrapperForMemory) {
             std::stringstream ss;
             ss << "expression wrapper for memory id " << expressionWrapperForMemoryId
                << " is not found";
             throw std::runtime_error(ss.str());
         }
-        semanticMemory.memBloc.removeExpression(*it->second, lingDb, nullptr);
-        _idToExpWrapperForMemory.erase(it);
+        semanticMemory.memBloc.removeExpression(*expressionWrapperForMemory, lingDb, nullptr);
+        _idToExpWrapperForMemory.remove(expressionWrapperForMemoryId);
+        // The expressions cannot be identified in the journal and the replay of the previous records
+        // would undo the forget, so a snapshot is needed now
+        if (auto *journal = lockedSemanticMemory.journal())
+            journal->requestImmediateCompaction();
     });
 }
 
@@ -475,10 +596,10 @@ Java_com_onsem_OnsemKt_notKnowing(
         jobject semanticMemoryJObj,
         jobject linguisticDatabaseJObj) {
     return convertCppExceptionsToJavaExceptionsAndReturnTheResult<jobject>(env, [&]() {
-        std::lock_guard<std::mutex> lock(_jniReferencesMutex);
-        auto &lingDb = getLingDb(env, linguisticDatabaseJObj);
-        auto &semanticMemory = getSemanticMemory(env, semanticMemoryJObj);
-        auto &semExp = getSemExp(env, semanticExpressionJObj);
+        auto semExpPtr = getSemExp(env, semanticExpressionJObj);
+        auto &semExp = *semExpPtr;
+        // The semantic memory and the linguistic database are not used, so they are not locked or pinned
+        // (it can be called while another operation is too long)
         return semanticExpressionPtrToJobject(env, memoryOperation::notKnowing(*semExp));
     }, nullptr);
 }
@@ -492,12 +613,22 @@ Java_com_onsem_OnsemKt_answer(
         jobject semanticMemoryJObj,
         jobject linguisticDatabaseJObj) {
     return convertCppExceptionsToJavaExceptionsAndReturnTheResult<jobject>(env, [&]() {
-        std::lock_guard<std::mutex> lock(_jniReferencesMutex);
-        auto &lingDb = getLingDb(env, linguisticDatabaseJObj);
-        auto &semanticMemory = getSemanticMemory(env, semanticMemoryJObj);
-        auto &semExp = getSemExp(env, semanticExpressionJObj);
-        return semanticExpressionPtrToJobject(env, memoryOperation::answer(semExp->clone(), false,
-                                                                           semanticMemory, lingDb));
+        auto semExpPtr = getSemExp(env, semanticExpressionJObj);
+        return _answer(env, (*semExpPtr)->clone(), semanticMemoryJObj, linguisticDatabaseJObj);
+    }, nullptr);
+}
+
+
+extern "C"
+JNIEXPORT jobject JNICALL
+Java_com_onsem_OnsemKt_answerAndConsumeCpp(
+        JNIEnv *env, jclass /*clazz*/,
+        jobject semanticExpressionJObj,
+        jobject semanticMemoryJObj,
+        jobject linguisticDatabaseJObj) {
+    return convertCppExceptionsToJavaExceptionsAndReturnTheResult<jobject>(env, [&]() {
+        return _answer(env, takeSemExp(env, semanticExpressionJObj), semanticMemoryJObj,
+                       linguisticDatabaseJObj);
     }, nullptr);
 }
 
@@ -510,12 +641,16 @@ Java_com_onsem_OnsemKt_execute(
         jobject semanticMemoryJObj,
         jobject linguisticDatabaseJObj) {
     return convertCppExceptionsToJavaExceptionsAndReturnTheResult<jobject>(env, [&]() {
-        std::lock_guard<std::mutex> lock(_jniReferencesMutex);
-        auto &lingDb = getLingDb(env, linguisticDatabaseJObj);
-        auto &semanticMemory = getSemanticMemory(env, semanticMemoryJObj);
-        auto &semExp = getSemExp(env, semanticExpressionJObj);
-        return semanticExpressionPtrToJobject(env, memoryOperation::execute(*semExp, semanticMemory,
-                                                                            lingDb));
+        auto lingDbPtr = getLingDb(env, linguisticDatabaseJObj);
+        auto &lingDb = *lingDbPtr;
+        auto semExpPtr = getSemExp(env, semanticExpressionJObj);
+        auto &semExp = *semExpPtr;
+        auto lockedSemanticMemory = writeSemanticMemory(env, semanticMemoryJObj);
+        auto &semanticMemory = *lockedSemanticMemory;
+        auto res = memoryOperation::execute(*semExp, semanticMemory, lingDb);
+        // The executions are not journaled
+        lockedSemanticMemory.requestCompaction();
+        return semanticExpressionPtrToJobject(env, std::move(res));
     }, nullptr);
 }
 
@@ -528,12 +663,16 @@ Java_com_onsem_OnsemKt_executeFromCondition(
         jobject semanticMemoryJObj,
         jobject linguisticDatabaseJObj) {
     return convertCppExceptionsToJavaExceptionsAndReturnTheResult<jobject>(env, [&]() {
-        std::lock_guard<std::mutex> lock(_jniReferencesMutex);
-        auto &lingDb = getLingDb(env, linguisticDatabaseJObj);
-        auto &semanticMemory = getSemanticMemory(env, semanticMemoryJObj);
-        auto &semExp = getSemExp(env, semanticExpressionJObj);
-        return semanticExpressionPtrToJobject(env, memoryOperation::executeFromCondition(
-                *semExp, semanticMemory, lingDb));
+        auto lingDbPtr = getLingDb(env, linguisticDatabaseJObj);
+        auto &lingDb = *lingDbPtr;
+        auto semExpPtr = getSemExp(env, semanticExpressionJObj);
+        auto &semExp = *semExpPtr;
+        auto lockedSemanticMemory = writeSemanticMemory(env, semanticMemoryJObj);
+        auto &semanticMemory = *lockedSemanticMemory;
+        auto res = memoryOperation::executeFromCondition(*semExp, semanticMemory, lingDb);
+        // The executions are not journaled
+        lockedSemanticMemory.requestCompaction();
+        return semanticExpressionPtrToJobject(env, std::move(res));
     }, nullptr);
 }
 
@@ -546,15 +685,18 @@ Java_com_onsem_OnsemKt_sayFeedback(
         jobject semanticMemoryJObj,
         jobject linguisticDatabaseJObj) {
     return convertCppExceptionsToJavaExceptionsAndReturnTheResult<jobject>(env, [&]() {
-        std::lock_guard<std::mutex> lock(_jniReferencesMutex);
-        auto &lingDb = getLingDb(env, linguisticDatabaseJObj);
-        auto &semanticMemory = getSemanticMemory(env, semanticMemoryJObj);
-        auto &semExp = getSemExp(env, semanticExpressionJObj);
+        auto lingDbPtr = getLingDb(env, linguisticDatabaseJObj);
+        auto &lingDb = *lingDbPtr;
+        auto semExpPtr = getSemExp(env, semanticExpressionJObj);
+        auto &semExp = *semExpPtr;
+        auto lockedSemanticMemory = writeSemanticMemory(env, semanticMemoryJObj);
+        auto &semanticMemory = *lockedSemanticMemory;
         auto typeOfFeedback = toTypeOfFeedback(env, typeOfFeedbackJObj,
-                                               getSemanticEnumsIndexes(env));
-        return semanticExpressionPtrToJobject(env,
-                                              memoryOperation::sayFeedback(*semExp, typeOfFeedback,
-                                                                           semanticMemory, lingDb));
+                                               getSemanticEnumsIndexes());
+        auto res = memoryOperation::sayFeedback(*semExp, typeOfFeedback, semanticMemory, lingDb);
+        // The feedbacks are not journaled
+        lockedSemanticMemory.requestCompaction();
+        return semanticExpressionPtrToJobject(env, std::move(res));
     }, nullptr);
 }
 
@@ -565,8 +707,8 @@ Java_com_onsem_OnsemKt_categorizeCpp(
         JNIEnv *env, jclass /*clazz*/,
         jobject semanticExpressionJObj) {
     return convertCppExceptionsToJavaExceptionsAndReturnTheResult<jstring>(env, [&]() {
-        std::lock_guard<std::mutex> lock(_jniReferencesMutex);
-        auto &semExp = getSemExp(env, semanticExpressionJObj);
+        auto semExpPtr = getSemExp(env, semanticExpressionJObj);
+        auto &semExp = *semExpPtr;
         auto textCategory = memoryOperation::categorize(*semExp);
         return env->NewStringUTF(semanticExpressionCategory_toStr(textCategory).c_str());
     }, nullptr);
@@ -581,10 +723,12 @@ Java_com_onsem_OnsemKt_learnSayCommand(
         jobject semanticMemoryJObj,
         jobject linguisticDatabaseJObj) {
     convertCppExceptionsToJavaExceptions(env, [&]() {
-        std::lock_guard<std::mutex> lock(_jniReferencesMutex);
-        auto &lingDb = getLingDb(env, linguisticDatabaseJObj);
-        auto &semanticMemory = getSemanticMemory(env, semanticMemoryJObj);
+        auto lingDbPtr = getLingDb(env, linguisticDatabaseJObj);
+        auto &lingDb = *lingDbPtr;
+        auto lockedSemanticMemory = writeSemanticMemory(env, semanticMemoryJObj);
+        auto &semanticMemory = *lockedSemanticMemory;
         memoryOperation::learnSayCommand(semanticMemory, lingDb);
+        lockedSemanticMemory.requestCompaction();
     });
 }
 
@@ -594,9 +738,10 @@ Java_com_onsem_OnsemKt_allowToInformTheUserHowToTeach(
         JNIEnv *env, jclass /*clazz*/,
         jobject semanticMemoryJObj) {
     convertCppExceptionsToJavaExceptions(env, [&]() {
-        std::lock_guard<std::mutex> lock(_jniReferencesMutex);
-        auto &semanticMemory = getSemanticMemory(env, semanticMemoryJObj);
+        auto lockedSemanticMemory = writeSemanticMemory(env, semanticMemoryJObj);
+        auto &semanticMemory = *lockedSemanticMemory;
         memoryOperation::allowToInformTheUserHowToTeach(semanticMemory);
+        lockedSemanticMemory.requestCompaction();
     });
 }
 
@@ -604,7 +749,6 @@ extern "C"
 JNIEXPORT jstring JNICALL
 Java_com_onsem_OnsemKt_getStringReportOfTheNumberOfObjectsInMemoryToSpotLeakForDebug(
         JNIEnv *env, jclass /*clazz*/) {
-    std::lock_guard<std::mutex> lock(_jniReferencesMutex);
     std::stringstream ss;
     {
         auto numberOfObjects = _idToExpWrapperForMemory.size();
@@ -646,17 +790,40 @@ Java_com_onsem_OnsemKt_getLocaleFromText(
         JNIEnv *env, jclass /*clazz*/,
         jstring textJStr,
         jobject linguisticDatabaseJObj) {
-    std::string languageStr = "un";
     return convertCppExceptionsToJavaExceptionsAndReturnTheResult<jstring>(env, [&]() {
-        std::lock_guard<std::mutex> lock(_jniReferencesMutex);
         auto textStr = toString(env, textJStr);
-        auto &lingDb = getLingDb(env, linguisticDatabaseJObj);
-        auto language = linguistics::getLanguage(textStr, lingDb);
-        if (language == SemanticLanguageEnum::FRENCH)
-            languageStr = "fr";
-        else if (language == SemanticLanguageEnum::ENGLISH)
-            languageStr = "en";
-        return env->NewStringUTF(languageStr.c_str());
-    }, env->NewStringUTF(languageStr.c_str()));
+        auto languageIdentifier = getLanguageIdentifier(env, linguisticDatabaseJObj);
+        return env->NewStringUTF(_languageToLocaleStr(languageIdentifier->identify(textStr)));
+    }, env->NewStringUTF(_languageToLocaleStr(SemanticLanguageEnum::UNKNOWN)));
+}
+
+
+extern "C"
+JNIEXPORT jobjectArray JNICALL
+Java_com_onsem_OnsemKt_getLocalesFromTexts(
+        JNIEnv *env, jclass /*clazz*/,
+        jobjectArray textsJArray,
+        jobject linguisticDatabaseJObj) {
+    return convertCppExceptionsToJavaExceptionsAndReturnTheResult<jobjectArray>(env, [&]() {
+        auto texts = javaArrayToStlStringVector(env, textsJArray);
+        auto languageIdentifier = getLanguageIdentifier(env, linguisticDatabaseJObj);
+
+        // Most of the texts are settled by the prefilters or the cache, so only the others use the threads
+        std::vector<SemanticLanguageEnum> languages(texts.size(), SemanticLanguageEnum::UNKNOWN);
+        std::vector<std::size_t> textIndexesToLookUp;
+        for (std::size_t i = 0; i < texts.size(); ++i)
+            if (!languageIdentifier->identifyQuickly(texts[i], languages[i]))
+                textIndexesToLookUp.push_back(i);
+        runInParallel(textIndexesToLookUp.size(), getNbOfWorkerThreads(), [&](std::size_t pIndex) {
+            auto textIndex = textIndexesToLookUp[pIndex];
+            languages[textIndex] = languageIdentifier->identify(texts[textIndex]);
+        });
+
+        std::vector<std::string> locales;
+        locales.reserve(languages.size());
+        for (auto currLanguage : languages)
+            locales.emplace_back(_languageToLocaleStr(currLanguage));
+        return stlStringVectorToJavaArray(env, locales);
+    }, nullptr);
 }
 
@@ -5,17 +5,33 @@
 #include <mutex>
 #include <map>
 #include "onsem/semantictotext/semanticmemory/links/expressionwithlinks.hpp"
+#include "javabindings.hpp"
 
 namespace onsem {
     struct ExpressionWithLinks;
     struct SemanticMemory;
     struct SemanticExpression;
 }
+class WriteLockedSemanticMemory;
 
+
+/*
+ * The JNI entry points are of 3 kinds:
+ *  - Pure: they only use objects that are never modified after their construction (the linguistic
+ *    databases, the semantic expressions and the text processing contexts), so they only pin these objects
+ *    with their shared pointers and they take no lock except the shared lookup of the ids.
+ *    (e.g. isAProperNoun, categorizeCpp, getLocaleFromText, notKnowing and the parsing of the texts)
+ *  - Reading a memory: they lock the semantic memory in read mode (cf readSemanticMemory),
+ *    so they run in parallel with the other readers of the memory.
+ *  - Mutating a memory: they lock the semantic memory in write mode (cf writeSemanticMemory).
+ * A pure step of a function (e.g. the parsing of textToSemanticExpression) is done before locking the memory.
+ */
+
+/// The texts are taken from the synthesis cache of the memory if it has one.
 void runOutputter(
         JNIEnv *env,
         onsem::SemanticLanguageEnum pLanguage,
-        onsem::SemanticMemory& pSemMemory,
+        const WriteLockedSemanticMemory& pLockedSemMemory,
         onsem::linguistics::LinguisticDatabase& pLingDb,
         const onsem::SemanticExpression& pSemExp,
         jobject jOutputter,
@@ -25,23 +41,6 @@ void runOutputter(
 void convertCppExceptionsToJavaExceptions(JNIEnv *env, const std::function<void()> &pFunction);
 
 
-/// Any JNI function that will deal with references maintained across the JNI should use this lock.
-void protectByMutex(const std::function<void()>& pFunction);
-template<typename T>
-T protectByMutexWithReturn(const std::function<T()>& pFunction);
-
-template<typename T>
-jint findMissingKey(const std::map<jint, T> &pIdToObj) {
-    jint currentId = 0;
-    for (const auto &currMemory : pIdToObj) {
-        int nextId = currentId + 1;
-        if (currMemory.first > nextId)
-            return nextId;
-        currentId = currMemory.first;
-    }
-    return currentId + 1;
-}
-
 /**
  * Convert C++ exception to java exception and as java exceptions don't stop the flow,
  * we need to return an object that corresponds to what the JNI wants. (that is why we have a default value)
@@ -54,11 +53,27 @@ T convertCppExceptionsToJavaExceptionsAndReturnTheResult(
     try {
         return pFunction();
     } catch (const std::exception &e) {
-        env->ThrowNew(env->FindClass("java/lang/RuntimeException"), e.what());
+        env->ThrowNew(getJavaBindings().runtimeExceptionClass, e.what());
     }
     return pDefaultReturn;
 }
 
+// JNI functions that are also run on the worker threads by the asynchronous operations (cf onsemasync-jni.cpp)
+extern "C" {
+JNIEXPORT jobject JNICALL Java_com_onsem_OnsemKt_inform(
+        JNIEnv *env, jclass clazz, jobject semanticExpressionJObj, jobject locale, jobject semanticMemoryJObj,
+        jobject linguisticDatabaseJObj, jobject jOutputter, jboolean informAboutWhatWasDone);
+JNIEXPORT jstring JNICALL Java_com_onsem_OnsemKt_reactCpp(
+        JNIEnv *env, jclass clazz, jobject semanticExpressionJObj, jobject locale, jobject semanticMemoryJObj,
+        jobject linguisticDatabaseJObj, jobject jOutputter, jboolean informAboutWhatWasDone);
+JNIEXPORT jstring JNICALL Java_com_onsem_OnsemKt_callOperatorsCpp(
+        JNIEnv *env, jclass clazz, jobjectArray operatorsJObj, jobject semanticExpressionJObj, jobject locale,
+        jobject semanticMemoryJObj, jobject linguisticDatabaseJObj, jobject jOutputter);
+JNIEXPORT jobject JNICALL Java_com_onsem_OnsemKt_answer(
+        JNIEnv *env, jclass clazz, jobject semanticExpressionJObj, jobject semanticMemoryJObj,
+        jobject linguisticDatabaseJObj);
+}
+
 jobject newExpressionWithLinks(
         JNIEnv *env,
         const std::shared_ptr<onsem::ExpressionWithLinks> &pExp);
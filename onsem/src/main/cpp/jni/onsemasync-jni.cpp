@@ -0,0 +1,146 @@
+#include <functional>
+#include <memory>
+#include <jni.h>
+#include "onsem-jni.h"
+#include "jobjectstocpptypes.hpp"
+#include "javabindings.hpp"
+#include "workerpool.hpp"
+
+
+namespace {
+    std::shared_ptr<JavaGlobalRef> _globalRef(JNIEnv *env, jobject pObject) {
+        return std::make_shared<JavaGlobalRef>(env, pObject);
+    }
+
+    /**
+     * Run an operation on the worker pool, after the previous operations of the same semantic memory.
+     * The result of the operation, or the java exception that it raised, is given to the callback.
+     * The operation is skipped if the callback is cancelled before the start of the operation.
+     * A running operation is never interrupted, the onsem functions have no cancellation point.
+     */
+    void _submit(JNIEnv *env,
+                 jobject pSemanticMemoryJObj,
+                 jobject pCallbackJObj,
+                 std::function<jobject(JNIEnv *)> pOperation) {
+        auto semanticMemoryId = toDisposableWithIdId(env, pSemanticMemoryJObj);
+        auto callback = _globalRef(env, pCallbackJObj);
+        getWorkerPool(env).submit(semanticMemoryId, [callback, operation = std::move(pOperation)](JNIEnv *workerEnv) {
+            const auto &javaBindings = getJavaBindings();
+            // Nobody waits for the result anymore
+            if (workerEnv->GetBooleanField(callback->get(), javaBindings.nativeCallbackIsCancelledField))
+                return;
+            jobject result = operation(workerEnv);
+            jthrowable error = workerEnv->ExceptionOccurred();
+            if (error) {
+                workerEnv->ExceptionClear();
+                workerEnv->CallVoidMethod(callback->get(), javaBindings.nativeCallbackOnFailureMethod, error);
+            } else {
+                workerEnv->CallVoidMethod(callback->get(), javaBindings.nativeCallbackOnSuccessMethod, result);
+            }
+        }, [callback](JNIEnv *workerEnv, jthrowable pError) {
+            // The operation could not be run, or it failed outside of the conversion of its exceptions
+            workerEnv->CallVoidMethod(callback->get(), getJavaBindings().nativeCallbackOnFailureMethod, pError);
+        });
+    }
+}
+
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_onsem_OnsemAsyncKt_submitInform(
+        JNIEnv *env, jclass /*clazz*/,
+        jobject semanticExpressionJObj,
+        jobject locale,
+        jobject semanticMemoryJObj,
+        jobject linguisticDatabaseJObj,
+        jobject jOutputter,
+        jboolean informAboutWhatWasDone,
+        jobject callbackJObj) {
+    convertCppExceptionsToJavaExceptions(env, [&]() {
+        auto semExp = _globalRef(env, semanticExpressionJObj);
+        auto localeRef = _globalRef(env, locale);
+        auto semanticMemory = _globalRef(env, semanticMemoryJObj);
+        auto lingDb = _globalRef(env, linguisticDatabaseJObj);
+        auto outputter = _globalRef(env, jOutputter);
+        _submit(env, semanticMemoryJObj, callbackJObj, [=](JNIEnv *workerEnv) -> jobject {
+            return Java_com_onsem_OnsemKt_inform(workerEnv, nullptr, semExp->get(), localeRef->get(),
+                                                 semanticMemory->get(), lingDb->get(), outputter->get(),
+                                                 informAboutWhatWasDone);
+        });
+    });
+}
+
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_onsem_OnsemAsyncKt_submitReact(
+        JNIEnv *env, jclass /*clazz*/,
+        jobject semanticExpressionJObj,
+        jobject locale,
+        jobject semanticMemoryJObj,
+        jobject linguisticDatabaseJObj,
+        jobject jOutputter,
+        jboolean informAboutWhatWasDone,
+        jobject callbackJObj) {
+    convertCppExceptionsToJavaExceptions(env, [&]() {
+        auto semExp = _globalRef(env, semanticExpressionJObj);
+        auto localeRef = _globalRef(env, locale);
+        auto semanticMemory = _globalRef(env, semanticMemoryJObj);
+        auto lingDb = _globalRef(env, linguisticDatabaseJObj);
+        auto outputter = _globalRef(env, jOutputter);
+        _submit(env, semanticMemoryJObj, callbackJObj, [=](JNIEnv *workerEnv) -> jobject {
+            return Java_com_onsem_OnsemKt_reactCpp(workerEnv, nullptr, semExp->get(), localeRef->get(),
+                                                   semanticMemory->get(), lingDb->get(), outputter->get(),
+                                                   informAboutWhatWasDone);
+        });
+    });
+}
+
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_onsem_OnsemAsyncKt_submitCallOperators(
+        JNIEnv *env, jclass /*clazz*/,
+        jobjectArray operatorsJObj,
+        jobject semanticExpressionJObj,
+        jobject locale,
+        jobject semanticMemoryJObj,
+        jobject linguisticDatabaseJObj,
+        jobject jOutputter,
+        jobject callbackJObj) {
+    convertCppExceptionsToJavaExceptions(env, [&]() {
+        auto operators = _globalRef(env, operatorsJObj);
+        auto semExp = _globalRef(env, semanticExpressionJObj);
+        auto localeRef = _globalRef(env, locale);
+        auto semanticMemory = _globalRef(env, semanticMemoryJObj);
+        auto lingDb = _globalRef(env, linguisticDatabaseJObj);
+        auto outputter = _globalRef(env, jOutputter);
+        _submit(env, semanticMemoryJObj, callbackJObj, [=](JNIEnv *workerEnv) -> jobject {
+            return Java_com_onsem_OnsemKt_callOperatorsCpp(workerEnv, nullptr,
+                                                           static_cast<jobjectArray>(operators->get()),
+                                                           semExp->get(), localeRef->get(),
+                                                           semanticMemory->get(), lingDb->get(),
+                                                           outputter->get());
+        });
+    });
+}
+
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_onsem_OnsemAsyncKt_submitAnswer(
+        JNIEnv *env, jclass /*clazz*/,
+        jobject semanticExpressionJObj,
+        jobject semanticMemoryJObj,
+        jobject linguisticDatabaseJObj,
+        jobject callbackJObj) {
+    convertCppExceptionsToJavaExceptions(env, [&]() {
+        auto semExp = _globalRef(env, semanticExpressionJObj);
+        auto semanticMemory = _globalRef(env, semanticMemoryJObj);
+        auto lingDb = _globalRef(env, linguisticDatabaseJObj);
+        _submit(env, semanticMemoryJObj, callbackJObj, [=](JNIEnv *workerEnv) -> jobject {
+            return Java_com_onsem_OnsemKt_answer(workerEnv, nullptr, semExp->get(), semanticMemory->get(),
+                                                 lingDb->get());
+        });
+    });
+}
\ No newline at end of file
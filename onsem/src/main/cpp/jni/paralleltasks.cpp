@@ -0,0 +1,121 @@
+#include "paralleltasks.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+namespace {
+    /// Threads that run the helpers of runInParallel, in the order of their submission.
+    class ParallelTasksPool {
+    public:
+        explicit ParallelTasksPool(std::size_t pNbOfThreads)
+                : _mutex(),
+                  _jobReady(),
+                  _jobs(),
+                  _threads() {
+            for (std::size_t i = 0; i < pNbOfThreads; ++i)
+                _threads.emplace_back([this]() { _run(); });
+        }
+
+        void submit(std::function<void()> pJob) {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _jobs.push_back(std::move(pJob));
+            }
+            _jobReady.notify_one();
+        }
+
+    private:
+        std::mutex _mutex;
+        std::condition_variable _jobReady;
+        std::deque<std::function<void()>> _jobs;
+        std::vector<std::thread> _threads;
+
+        void _run() {
+            std::unique_lock<std::mutex> lock(_mutex);
+            while (true) {
+                _jobReady.wait(lock, [this]() { return !_jobs.empty(); });
+                auto job = std::move(_jobs.front());
+                _jobs.pop_front();
+                lock.unlock();
+                job();
+                job = nullptr;
+                lock.lock();
+            }
+        }
+    };
+
+
+    ParallelTasksPool &_getParallelTasksPool() {
+        // Never deleted, because the threads cannot be joined safely while the process exits
+        // (the current thread of a call is the last thread of its tasks)
+        static auto *pool = new ParallelTasksPool(std::max<std::size_t>(getNbOfWorkerThreads(), 2) - 1);
+        return *pool;
+    }
+
+
+    /**
+     * State of a call of runInParallel, shared with its helpers.
+     * A helper can start after the end of all the tasks, and even after the end of the call,
+     * so it only keeps this state alive and it finds no task to run.
+     */
+    struct ParallelTasks {
+        ParallelTasks(std::size_t pNbOfTasks, const std::function<void(std::size_t)> &pTask)
+                : nbOfTasks(pNbOfTasks),
+                  task(pTask),
+                  nextTaskIndex(0),
+                  errors(pNbOfTasks),
+                  mutex(),
+                  allTasksDone(),
+                  nbOfDoneTasks(0) {
+        }
+
+        void runNextTasks() {
+            for (auto i = nextTaskIndex++; i < nbOfTasks; i = nextTaskIndex++) {
+                try {
+                    task(i);
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                }
+                std::lock_guard<std::mutex> lock(mutex);
+                if (++nbOfDoneTasks == nbOfTasks)
+                    allTasksDone.notify_all();
+            }
+        }
+
+        const std::size_t nbOfTasks;
+        /// Only used while the call waits for its tasks.
+        const std::function<void(std::size_t)> &task;
+        std::atomic<std::size_t> nextTaskIndex;
+        std::vector<std::exception_ptr> errors;
+        std::mutex mutex;
+        std::condition_variable allTasksDone;
+        std::size_t nbOfDoneTasks;
+    };
+}
+
+
+void runInParallel(std::size_t pNbOfTasks,
+                   std::size_t pNbOfThreads,
+                   const std::function<void(std::size_t)> &pTask) {
+    auto tasks = std::make_shared<ParallelTasks>(pNbOfTasks, pTask);
+    auto nbOfThreads = std::min(pNbOfThreads, pNbOfTasks);
+    if (nbOfThreads > 1) {
+        auto &pool = _getParallelTasksPool();
+        for (std::size_t i = 1; i < nbOfThreads; ++i)
+            pool.submit([tasks]() { tasks->runNextTasks(); });
+    }
+    tasks->runNextTasks();
+    {
+        std::unique_lock<std::mutex> lock(tasks->mutex);
+        tasks->allTasksDone.wait(lock, [&tasks]() { return tasks->nbOfDoneTasks == tasks->nbOfTasks; });
+    }
+
+    for (const auto &currError : tasks->errors)
+        if (currError)
+            std::rethrow_exception(currError);
+}
\ No newline at end of file
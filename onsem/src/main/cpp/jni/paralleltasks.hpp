@@ -0,0 +1,29 @@
+#ifndef SEMANTIC_ANDROID_PARALLELTASKS_HPP
+#define SEMANTIC_ANDROID_PARALLELTASKS_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <thread>
+
+
+/// Number of threads to use for the tasks that are split by the JNI.
+inline std::size_t getNbOfWorkerThreads() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+
+/**
+ * Call pTask for each index in [0, pNbOfTasks), on pNbOfThreads threads (the current thread included).
+ * The other threads are taken from a pool that lives as long as the process, so no thread is created
+ * by a call, and the current thread also runs the tasks so the call ends even if the pool is busy.
+ * The threads of the pool are not attached to the java VM, so the tasks must not use the JNI.
+ * The tasks are all executed even if some of them fail, then the error of the first failing task
+ * (in the order of the indexes) is rethrown, so the result does not depend on the threads.
+ */
+void runInParallel(std::size_t pNbOfTasks,
+                   std::size_t pNbOfThreads,
+                   const std::function<void(std::size_t)> &pTask);
+
+
+#endif // SEMANTIC_ANDROID_PARALLELTASKS_HPP
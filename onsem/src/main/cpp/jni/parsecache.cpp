@@ -0,0 +1,47 @@
+#include "parsecache.hpp"
+#include <cctype>
+
+using namespace onsem;
+
+
+ParseCache::ParseCache(std::size_t pMaxSize)
+        : _keyToSemExp(pMaxSize),
+          _nbOfHits(0),
+          _nbOfMisses(0) {
+}
+
+
+UniqueSemanticExpression ParseCache::getOrParse(
+        const std::string &pKey,
+        const std::function<UniqueSemanticExpression()> &pParse) {
+    std::shared_ptr<const UniqueSemanticExpression> cachedSemExp;
+    if (_keyToSemExp.get(pKey, cachedSemExp)) {
+        ++_nbOfHits;
+        // The cached expressions are never modified, so they can be cloned without the lock
+        return (*cachedSemExp)->clone();
+    }
+
+    // The parsing is done without the lock, so that several texts can be parsed in parallel
+    ++_nbOfMisses;
+    auto res = pParse();
+    _keyToSemExp.put(pKey, std::make_shared<const UniqueSemanticExpression>(res->clone()));
+    return res;
+}
+
+
+std::string normalizeTextForParseCache(const std::string &pText) {
+    std::string res;
+    res.reserve(pText.size());
+    bool previousIsASpace = false;
+    for (char currChar : pText) {
+        if (std::isspace(static_cast<unsigned char>(currChar))) {
+            previousIsASpace = true;
+            continue;
+        }
+        if (previousIsASpace && !res.empty())
+            res += ' ';
+        previousIsASpace = false;
+        res += currChar;
+    }
+    return res;
+}
\ No newline at end of file
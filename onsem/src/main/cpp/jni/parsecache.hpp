@@ -0,0 +1,43 @@
+#ifndef SEMANTIC_ANDROID_PARSECACHE_HPP
+#define SEMANTIC_ANDROID_PARSECACHE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <onsem/texttosemantic/dbtype/semanticexpression/semanticexpression.hpp>
+#include "lrucache.hpp"
+
+
+/**
+ * Cache of the texts converted to semantic expressions, before their merge with the context of a memory.
+ * The least recently used expression is removed when the cache is full.
+ * The cached expressions are never given, only their clones.
+ * It can be used from several threads.
+ */
+class ParseCache {
+public:
+    explicit ParseCache(std::size_t pMaxSize);
+
+    /// The key has to identify the text and all the parameters of the parsing.
+    onsem::UniqueSemanticExpression getOrParse(
+            const std::string &pKey,
+            const std::function<onsem::UniqueSemanticExpression()> &pParse);
+
+    std::uint64_t nbOfHits() const { return _nbOfHits; }
+    std::uint64_t nbOfMisses() const { return _nbOfMisses; }
+
+private:
+    LruCache<std::shared_ptr<const onsem::UniqueSemanticExpression>> _keyToSemExp;
+    std::atomic<std::uint64_t> _nbOfHits;
+    std::atomic<std::uint64_t> _nbOfMisses;
+};
+
+
+/// Remove the spaces at the extremities and replace the other sequences of spaces by one space.
+std::string normalizeTextForParseCache(const std::string &pText);
+
+
+#endif // SEMANTIC_ANDROID_PARSECACHE_HPP
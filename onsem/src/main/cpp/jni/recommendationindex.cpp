@@ -0,0 +1,111 @@
+#include "recommendationindex.hpp"
+#include <algorithm>
+#include <map>
+#include "toprecommendations.hpp"
+
+
+namespace {
+    /// Coefficient of the features that have no coefficient. (the agents have a lower one, cf newRecommendationsFinder)
+    constexpr std::int32_t _defaultCoefficient = 10;
+}
+
+
+RecommendationIndex::RecommendationIndex()
+        : _featureToId(),
+          _coefficients(),
+          _postingLists(),
+          _idToRecommendationIndex(),
+          _ids(),
+          _featureIdsOfRecommendations() {
+}
+
+
+void RecommendationIndex::setCoefficient(const std::string &pFeature, std::int32_t pCoefficient) {
+    _coefficients[_internFeature(pFeature)] = pCoefficient;
+}
+
+
+void RecommendationIndex::add(const std::string &pId, const std::vector<std::string> &pFeatures) {
+    auto itRecommendation = _idToRecommendationIndex.find(pId);
+    if (itRecommendation == _idToRecommendationIndex.end()) {
+        itRecommendation = _idToRecommendationIndex.emplace(pId, static_cast<std::uint32_t>(_ids.size())).first;
+        _ids.emplace_back(pId);
+        _featureIdsOfRecommendations.emplace_back();
+    }
+    auto recommendationIndex = itRecommendation->second;
+
+    std::map<std::uint32_t, std::int32_t> featureIdToNbOfOccurrences;
+    for (const auto &currFeature : pFeatures)
+        ++featureIdToNbOfOccurrences[_internFeature(currFeature)];
+
+    auto &featureIds = _featureIdsOfRecommendations[recommendationIndex];
+    for (const auto &currFeature : featureIdToNbOfOccurrences) {
+        auto itFeatureId = std::lower_bound(featureIds.begin(), featureIds.end(), currFeature.first);
+        if (itFeatureId != featureIds.end() && *itFeatureId == currFeature.first)
+            continue;
+        featureIds.insert(itFeatureId, currFeature.first);
+        auto &postingList = _postingLists[currFeature.first];
+        postingList.recommendationIndexes.push_back(recommendationIndex);
+        postingList.weights.push_back(currFeature.second * _coefficients[currFeature.first]);
+    }
+}
+
+
+void RecommendationIndex::findTop(const std::vector<std::string> &pInputFeatures,
+                                  TopRecommendations &pTopRecommendations) const {
+    std::vector<std::uint32_t> inputFeatureIds;
+    for (const auto &currFeature : pInputFeatures) {
+        auto itFeatureId = _featureToId.find(currFeature);
+        if (itFeatureId != _featureToId.end())
+            inputFeatureIds.push_back(itFeatureId->second);
+    }
+    std::sort(inputFeatureIds.begin(), inputFeatureIds.end());
+    inputFeatureIds.erase(std::unique(inputFeatureIds.begin(), inputFeatureIds.end()), inputFeatureIds.end());
+
+    // Only the recommendations of the posting lists are visited, so a query does not depend on the
+    // number of recommendations. The buffer of the scores is reused by the next queries of the thread,
+    // it is always zero outside of this function.
+    thread_local std::vector<std::int32_t> scores;
+    thread_local std::vector<std::uint32_t> touchedIndexes;
+    if (scores.size() < _ids.size())
+        scores.resize(_ids.size(), 0);
+    touchedIndexes.clear();
+    for (auto currFeatureId : inputFeatureIds) {
+        const auto &postingList = _postingLists[currFeatureId];
+        const auto *recommendationIndexes = postingList.recommendationIndexes.data();
+        const auto *weights = postingList.weights.data();
+        const auto nbOfRecommendations = postingList.recommendationIndexes.size();
+        for (std::size_t i = 0; i < nbOfRecommendations; ++i) {
+            auto &score = scores[recommendationIndexes[i]];
+            // A score that went back to zero can be touched twice, its second visit below sees a zero
+            if (score == 0)
+                touchedIndexes.push_back(recommendationIndexes[i]);
+            score += weights[i];
+        }
+    }
+
+    try {
+        for (auto currIndex : touchedIndexes) {
+            auto score = scores[currIndex];
+            scores[currIndex] = 0;
+            if (score > 0 && pTopRecommendations.canKeep(score))
+                pTopRecommendations.add(_ids[currIndex], score);
+        }
+    } catch (...) {
+        for (auto currIndex : touchedIndexes)
+            scores[currIndex] = 0;
+        throw;
+    }
+}
+
+
+std::uint32_t RecommendationIndex::_internFeature(const std::string &pFeature) {
+    auto itFeatureId = _featureToId.find(pFeature);
+    if (itFeatureId != _featureToId.end())
+        return itFeatureId->second;
+    auto featureId = static_cast<std::uint32_t>(_coefficients.size());
+    _featureToId.emplace(pFeature, featureId);
+    _coefficients.push_back(_defaultCoefficient);
+    _postingLists.emplace_back();
+    return featureId;
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#ifndef SEMANTIC_ANDROID_RECOMMENDATIONINDEX_HPP
+#define SEMANTIC_ANDROID_RECOMMENDATIONINDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class TopRecommendations;
+
+
+/**
+ * Index of the recommendations by the features of their groundings (e.g. their concepts), to score them
+ * without walking the semantic expressions.
+ * It is a ranking of its own, not the scoring of the SemanticRecommendationsContainer of onsem:
+ * the two can keep different recommendations and order them differently.
+ * The features are interned to consecutive ids, and each feature has a posting list stored as a
+ * structure of arrays: the indexes of the recommendations that have it and the weight of the feature
+ * in each of them. (the number of occurrences of the feature times the coefficient of the feature)
+ * The score of a recommendation is the sum of the weights of the features that it shares with the input,
+ * so the scoring is an accumulation over the posting lists of the features of the input.
+ * It can be read from several threads, but the modifications have to be exclusive.
+ */
+class RecommendationIndex {
+public:
+    RecommendationIndex();
+
+    /// Coefficient of a feature, it has to be set before the additions of the recommendations.
+    void setCoefficient(const std::string &pFeature, std::int32_t pCoefficient);
+    /// A recommendation added with several sets of features has the union of these features.
+    void add(const std::string &pId, const std::vector<std::string> &pFeatures);
+
+    /// Add the recommendations that share at least one feature with the input to pTopRecommendations.
+    /// Its cost depends on the lengths of the posting lists of the input features, not on the number of recommendations.
+    void findTop(const std::vector<std::string> &pInputFeatures,
+                 TopRecommendations &pTopRecommendations) const;
+
+    std::size_t size() const { return _ids.size(); }
+
+private:
+    struct PostingList {
+        std::vector<std::uint32_t> recommendationIndexes;
+        std::vector<std::int32_t> weights;
+    };
+
+    std::unordered_map<std::string, std::uint32_t> _featureToId;
+    /// Indexed by the feature ids.
+    std::vector<std::int32_t> _coefficients;
+    std::vector<PostingList> _postingLists;
+    std::unordered_map<std::string, std::uint32_t> _idToRecommendationIndex;
+    /// Indexed by the recommendation indexes.
+    std::vector<std::string> _ids;
+    /// The sorted feature ids of each recommendation, so that a feature is not indexed twice for a recommendation.
+    std::vector<std::vector<std::uint32_t>> _featureIdsOfRecommendations;
+
+    std::uint32_t _internFeature(const std::string &pFeature);
+};
+
+
+#endif // SEMANTIC_ANDROID_RECOMMENDATIONINDEX_HPP
@@ -0,0 +1,52 @@
+#include "recommendationsfile.hpp"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include "semanticserialization.hpp"
+
+using namespace onsem;
+
+namespace {
+    constexpr char _magic[8] = {'O', 'N', 'S', 'E', 'M', 'R', 'E', 'C'};
+    constexpr std::uint32_t _formatVersion = 1;
+}
+
+
+void writeRecommendationsFile(const std::string &pFilename,
+                              const std::vector<SavedRecommendation> &pRecommendations) {
+    binaryfile::writeFileAtomically(pFilename, [&](std::ostream &pOut) {
+        pOut.write(_magic, sizeof(_magic));
+        binaryfile::writeUint32(pOut, _formatVersion);
+        binaryfile::writeUint32(pOut, static_cast<std::uint32_t>(pRecommendations.size()));
+        for (const auto &currRecommendation : pRecommendations) {
+            binaryfile::writeString(pOut, currRecommendation.id);
+            binaryfile::writeUint32(pOut, static_cast<std::uint32_t>(currRecommendation.language));
+            binaryfile::writeString(pOut, currRecommendation.serializedSemExp);
+        }
+    });
+}
+
+
+std::vector<SavedRecommendation> readRecommendationsFile(const std::string &pFilename) {
+    std::ifstream in(pFilename, std::ios::binary);
+    if (!in)
+        throw std::runtime_error("cannot open the recommendations file " + pFilename);
+    char magic[sizeof(_magic)];
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, _magic, sizeof(_magic)) != 0)
+        throw std::runtime_error(pFilename + " is not a recommendations file");
+    auto formatVersion = binaryfile::readUint32(in);
+    if (formatVersion != _formatVersion)
+        throw std::runtime_error("unsupported version of recommendations file: " + std::to_string(formatVersion));
+    auto nbOfRecommendations = binaryfile::readUint32(in);
+    std::vector<SavedRecommendation> res;
+    // Not reserved from the count, so that a corrupted count fails on the truncated file instead of on the allocation
+    for (std::uint32_t i = 0; i < nbOfRecommendations; ++i) {
+        SavedRecommendation recommendation;
+        recommendation.id = binaryfile::readString(in);
+        recommendation.language = static_cast<SemanticLanguageEnum>(binaryfile::readUint32(in));
+        recommendation.serializedSemExp = binaryfile::readString(in);
+        res.emplace_back(std::move(recommendation));
+    }
+    return res;
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#ifndef SEMANTIC_ANDROID_RECOMMENDATIONSFILE_HPP
+#define SEMANTIC_ANDROID_RECOMMENDATIONSFILE_HPP
+
+#include <string>
+#include <vector>
+#include <onsem/common/enum/semanticlanguageenum.hpp>
+
+
+/**
+ * Recommendation that can be written in a file, so that a recommendations finder can be restored
+ * without parsing its texts again.
+ */
+struct SavedRecommendation {
+    std::string id;
+    onsem::SemanticLanguageEnum language = onsem::SemanticLanguageEnum::UNKNOWN;
+    /// Semantic expression of the text of the recommendation. (cf semExpToString)
+    std::string serializedSemExp;
+};
+
+/// The file is replaced atomically, so a crash during the writing keeps the previous file.
+void writeRecommendationsFile(const std::string &pFilename,
+                              const std::vector<SavedRecommendation> &pRecommendations);
+
+std::vector<SavedRecommendation> readRecommendationsFile(const std::string &pFilename);
+
+
+#endif // SEMANTIC_ANDROID_RECOMMENDATIONSFILE_HPP
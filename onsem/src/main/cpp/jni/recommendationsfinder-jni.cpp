@@ -1,8 +1,13 @@
 #include <jni.h>
+#include <algorithm>
 #include <cstddef>
 #include <map>
 #include <memory>
+#include <set>
 #include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
 #include <onsem/texttosemantic/dbtype/semanticexpression/groundedexpression.hpp>
 #include <onsem/texttosemantic/dbtype/semanticgrounding/semanticagentgrounding.hpp>
 #include <onsem/semantictotext/recommendations.hpp>
@@ -11,25 +16,123 @@
 #include "onsem-jni.h"
 #include "jobjectstocpptypes.hpp"
 #include "semanticexpression-jni.hpp"
+#include "objectregistry.hpp"
+#include "javabindings.hpp"
+#include "toprecommendations.hpp"
+#include "recommendationindex.hpp"
+#include "groundingfeatures.hpp"
+#include "recommendationsfile.hpp"
+#include "semanticserialization.hpp"
+#include "paralleltasks.hpp"
 
 
 using namespace onsem;
 
 namespace {
-    std::map<jint, std::unique_ptr<SemanticRecommendationsContainer>> _idToRecommendationContainer;
-
-    SemanticRecommendationsContainer &_getRecommendationsContainer(int pLingDbId) {
-        auto it = _idToRecommendationContainer.find(pLingDbId);
-        if (it == _idToRecommendationContainer.end()) {
-            std::stringstream ssErrorMessage;
-            ssErrorMessage << "wrong linguistic database id: " << pLingDbId;
-            throw std::runtime_error(ssErrorMessage.str());
+    /// Minimum number of candidates asked to onsem (it was the number before K was configurable),
+    /// so a small K selects among the same candidates as before.
+    constexpr std::size_t _minNbOfCandidates = 100;
+
+    /// The recommendations of onsem, and the same recommendations indexed by the features of their groundings.
+    /// (the index is another ranking than the one of onsem, only used if it is asked, cf RecommendationIndex)
+    struct RecommendationsFinder {
+        SemanticRecommendationsContainer container;
+        RecommendationIndex index;
+        /// The serialized semantic expressions of the recommendations, to save the finder without parsing again.
+        std::vector<SavedRecommendation> savedRecommendations;
+    };
+
+    ObjectRegistry<LockableObject<RecommendationsFinder>> _idToRecommendationsFinder("recommendations finder");
+
+    std::shared_ptr<LockableObject<RecommendationsFinder>> _getRecommendationsFinder(
+            JNIEnv *env, jobject pRecommendationsFinder) {
+        return _idToRecommendationsFinder.get(toDisposableWithIdId(env, pRecommendationsFinder));
+    }
+
+
+    /// Features of the groundings of an expression for the recommendation index.
+    std::vector<std::string> _indexFeatures(const SemanticExpression &pSemExp) {
+        std::vector<std::string> res;
+        forEachGroundingFeature(pSemExp, [&](GroundingFeatureKind pKind, const std::string &pFeature) {
+            switch (pKind) {
+                case GroundingFeatureKind::CONCEPT:
+                    res.emplace_back("concept:" + pFeature);
+                    break;
+                case GroundingFeatureKind::AGENT:
+                    res.emplace_back("agent:" + pFeature);
+                    break;
+                case GroundingFeatureKind::WORD:
+                    res.emplace_back("word:" + pFeature);
+                    break;
+            }
+        });
+        return res;
+    }
+
+
+    void _addGroundingCoef(RecommendationsFinder &pRecommendationsFinder,
+                           UniqueSemanticExpression pSemExp,
+                           int pCoef,
+                           const linguistics::LinguisticDatabase &pLingDb) {
+        for (const auto &currFeature : _indexFeatures(*pSemExp))
+            pRecommendationsFinder.index.setCoefficient(currFeature, pCoef);
+        addGroundingCoef(pRecommendationsFinder.container.goundingsToCoef, std::move(pSemExp), pCoef, pLingDb);
+    }
+
+
+    std::shared_ptr<LockableObject<RecommendationsFinder>> _newRecommendationsFinder(
+            const linguistics::LinguisticDatabase &pLingDb) {
+        auto res = std::make_shared<LockableObject<RecommendationsFinder>>();
+        _addGroundingCoef(res->object,
+                          std::make_unique<GroundedExpression>(
+                                  std::make_unique<SemanticAgentGrounding>(
+                                          SemanticAgentGrounding::currentUser)),
+                          1, pLingDb);
+        _addGroundingCoef(res->object,
+                          std::make_unique<GroundedExpression>(
+                                  std::make_unique<SemanticAgentGrounding>(
+                                          SemanticAgentGrounding::me)),
+                          1, pLingDb);
+        return res;
+    }
+
+
+    /// Recommendation prepared without the lock of the finder, so that only its insertion is under the lock.
+    struct PreparedRecommendation {
+        PreparedRecommendation(SavedRecommendation pSavedRecommendation, UniqueSemanticExpression pSemExp)
+                : savedRecommendation(std::move(pSavedRecommendation)),
+                  semExp(std::move(pSemExp)),
+                  indexFeatures(_indexFeatures(*semExp)) {
         }
-        return *it->second;
+
+        SavedRecommendation savedRecommendation;
+        UniqueSemanticExpression semExp;
+        std::vector<std::string> indexFeatures;
+    };
+
+    std::unique_ptr<PreparedRecommendation> _parseRecommendation(
+            const std::string &pText,
+            const std::string &pRecommendationId,
+            SemanticLanguageEnum pLanguage,
+            const TextProcessingContext &pTextProcessingContext,
+            const linguistics::LinguisticDatabase &pLingDb) {
+        auto semExp = converter::textToContextualSemExp(pText, pTextProcessingContext,
+                                                        SemanticSourceEnum::UNKNOWN, pLingDb);
+        SavedRecommendation savedRecommendation;
+        savedRecommendation.id = pRecommendationId;
+        savedRecommendation.language = pLanguage;
+        savedRecommendation.serializedSemExp = semExpToString(*semExp);
+        return std::make_unique<PreparedRecommendation>(std::move(savedRecommendation), std::move(semExp));
     }
 
-    SemanticRecommendationsContainer &_getRecommendationsContainer(JNIEnv *env, jobject pLingDb) {
-        return _getRecommendationsContainer(toDisposableWithIdId(env, pLingDb));
+    void _insertRecommendation(RecommendationsFinder &pRecommendationsFinder,
+                               PreparedRecommendation &&pRecommendation,
+                               const linguistics::LinguisticDatabase &pLingDb) {
+        const auto &recommendationId = pRecommendation.savedRecommendation.id;
+        pRecommendationsFinder.index.add(recommendationId, pRecommendation.indexFeatures);
+        addARecommendation(pRecommendationsFinder.container, std::move(pRecommendation.semExp), recommendationId,
+                           pLingDb);
+        pRecommendationsFinder.savedRecommendations.emplace_back(std::move(pRecommendation.savedRecommendation));
     }
 }
 
@@ -42,25 +145,8 @@ Java_com_onsem_RecommendationsFinderKt_newRecommendationsFinder(
 
     return convertCppExceptionsToJavaExceptionsAndReturnTheResult<jint>(env, [&]() {
 
-        jint id = 0;
-        protectByMutex([&] {
-            auto &lingDb = getLingDb(linguisticDatabaseId);
-            id = findMissingKey(_idToRecommendationContainer);
-
-            auto recommendationContainer = std::make_unique<SemanticRecommendationsContainer>();
-            addGroundingCoef(recommendationContainer->goundingsToCoef,
-                             std::make_unique<GroundedExpression>(
-                                     std::make_unique<SemanticAgentGrounding>(
-                                             SemanticAgentGrounding::currentUser)),
-                             1, lingDb);
-            addGroundingCoef(recommendationContainer->goundingsToCoef,
-                             std::make_unique<GroundedExpression>(
-                                     std::make_unique<SemanticAgentGrounding>(
-                                             SemanticAgentGrounding::me)),
-                             1, lingDb);
-            _idToRecommendationContainer.emplace(id, std::move(recommendationContainer));
-        });
-        return id;
+        auto lingDbPtr = getLingDb(linguisticDatabaseId);
+        return _idToRecommendationsFinder.add(_newRecommendationsFinder(*lingDbPtr));
     }, -1);
 }
 
@@ -70,9 +156,7 @@ extern "C"
 JNIEXPORT void JNICALL
 Java_com_onsem_RecommendationsFinderKt_deleteRecommendationsFinder(
         JNIEnv *env, jclass /*clazz*/, jint id) {
-    protectByMutex([&] {
-        _idToRecommendationContainer.erase(id);
-    });
+    _idToRecommendationsFinder.remove(id);
 }
 
 
@@ -86,68 +170,165 @@ Java_com_onsem_RecommendationsFinderKt_addRecommendation(
         jobject locale,
         jobject linguisticDatabaseJObj) {
     convertCppExceptionsToJavaExceptions(env, [&]() {
-        protectByMutex([&] {
-            auto &lingDb = getLingDb(env, linguisticDatabaseJObj);
-            auto &recommendationContainer = _getRecommendationsContainer(env,
-                                                                         recommendationsFinderJObj);
-
-            auto language = toLanguage(env, locale);
-            auto textStr = toString(env, textJStr);
-            auto recommendationIdStr = toString(env, recommendationIdJStr);
-
-            auto textProcessingContextToRobot = TextProcessingContext::getTextProcessingContextToRobot(
-                    language);
-            auto semExp = converter::textToContextualSemExp(textStr,
-                                                            textProcessingContextToRobot,
-                                                            SemanticSourceEnum::UNKNOWN,
-                                                            lingDb);
-            addARecommendation(recommendationContainer, std::move(semExp), recommendationIdStr,
-                               lingDb);
+        auto language = toLanguage(env, locale);
+        auto lingDbPtr = getLingDb(env, linguisticDatabaseJObj, language);
+        auto &lingDb = *lingDbPtr;
+
+        auto textStr = toString(env, textJStr);
+        auto recommendationIdStr = toString(env, recommendationIdJStr);
+
+        auto textProcessingContextToRobot = TextProcessingContext::getTextProcessingContextToRobot(
+                language);
+        auto recommendation = _parseRecommendation(textStr, recommendationIdStr, language,
+                                                   textProcessingContextToRobot, lingDb);
+        WriteLockedObject<RecommendationsFinder> recommendationsFinder(
+                _getRecommendationsFinder(env, recommendationsFinderJObj));
+        _insertRecommendation(*recommendationsFinder, std::move(*recommendation), lingDb);
+    });
+}
+
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_onsem_RecommendationsFinderKt_addRecommendationsBulk(
+        JNIEnv *env, jclass /*clazz*/,
+        jobject recommendationsFinderJObj,
+        jobjectArray textsJArray,
+        jobjectArray recommendationIdsJArray,
+        jobject locale,
+        jobject linguisticDatabaseJObj) {
+    convertCppExceptionsToJavaExceptions(env, [&]() {
+        auto language = toLanguage(env, locale);
+        auto lingDbPtr = getLingDb(env, linguisticDatabaseJObj, language);
+        auto &lingDb = *lingDbPtr;
+
+        auto texts = javaArrayToStlStringVector(env, textsJArray);
+        auto recommendationIds = javaArrayToStlStringVector(env, recommendationIdsJArray);
+        if (texts.size() != recommendationIds.size())
+            throw std::runtime_error("the number of texts and the number of recommendation ids are different");
+
+        // The parsing does not use the finder, so the texts are parsed in parallel and without its lock
+        auto textProcessingContextToRobot = TextProcessingContext::getTextProcessingContextToRobot(
+                language);
+        std::vector<std::unique_ptr<PreparedRecommendation>> recommendations(texts.size());
+        runInParallel(texts.size(), getNbOfWorkerThreads(), [&](std::size_t pIndex) {
+            recommendations[pIndex] = _parseRecommendation(texts[pIndex], recommendationIds[pIndex], language,
+                                                           textProcessingContextToRobot, lingDb);
         });
+
+        WriteLockedObject<RecommendationsFinder> recommendationsFinder(
+                _getRecommendationsFinder(env, recommendationsFinderJObj));
+        for (auto &currRecommendation : recommendations)
+            _insertRecommendation(*recommendationsFinder, std::move(*currRecommendation), lingDb);
+    });
+}
+
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_onsem_RecommendationsFinderKt_saveRecommendationsFinderCpp(
+        JNIEnv *env, jclass /*clazz*/,
+        jobject recommendationsFinderJObj,
+        jstring filenameJStr) {
+    convertCppExceptionsToJavaExceptions(env, [&]() {
+        auto filename = toString(env, filenameJStr);
+        std::vector<SavedRecommendation> savedRecommendations;
+        {
+            ReadLockedObject<RecommendationsFinder> recommendationsFinder(
+                    _getRecommendationsFinder(env, recommendationsFinderJObj));
+            savedRecommendations = recommendationsFinder->savedRecommendations;
+        }
+        // The file is written without the lock of the finder
+        writeRecommendationsFile(filename, savedRecommendations);
     });
 }
 
 
+extern "C"
+JNIEXPORT jint JNICALL
+Java_com_onsem_RecommendationsFinderKt_loadRecommendationsFinderCpp(
+        JNIEnv *env, jclass /*clazz*/,
+        jstring filenameJStr,
+        jobject linguisticDatabaseJObj) {
+    return convertCppExceptionsToJavaExceptionsAndReturnTheResult<jint>(env, [&]() {
+        auto savedRecommendations = readRecommendationsFile(toString(env, filenameJStr));
+        std::set<SemanticLanguageEnum> languages;
+        for (const auto &currRecommendation : savedRecommendations)
+            if (languages.insert(currRecommendation.language).second)
+                getLingDb(env, linguisticDatabaseJObj, currRecommendation.language);
+        auto lingDbPtr = getLingDb(env, linguisticDatabaseJObj);
+        auto &lingDb = *lingDbPtr;
+
+        // The semantic expressions are deserialized instead of parsing the texts again
+        std::vector<std::unique_ptr<PreparedRecommendation>> recommendations(savedRecommendations.size());
+        runInParallel(savedRecommendations.size(), getNbOfWorkerThreads(), [&](std::size_t pIndex) {
+            auto semExp = stringToSemExp(savedRecommendations[pIndex].serializedSemExp);
+            recommendations[pIndex] = std::make_unique<PreparedRecommendation>(
+                    std::move(savedRecommendations[pIndex]), std::move(semExp));
+        });
+
+        // The finder is not in the registry yet, so no other thread can use it during the loading
+        auto recommendationsFinder = _newRecommendationsFinder(lingDb);
+        recommendationsFinder->object.savedRecommendations.reserve(recommendations.size());
+        for (auto &currRecommendation : recommendations)
+            _insertRecommendation(recommendationsFinder->object, std::move(*currRecommendation), lingDb);
+        return _idToRecommendationsFinder.add(std::move(recommendationsFinder));
+    }, -1);
+}
+
+
 extern "C"
 JNIEXPORT jobjectArray JNICALL
-Java_com_onsem_RecommendationsFinderKt_getRecommendations(
+Java_com_onsem_RecommendationsFinderKt_getTopRecommendationsCpp(
         JNIEnv *env, jclass /*clazz*/,
         jobject recommendationsFinderJObj,
         jobject semExpJObj,
-        jobject linguisticDatabaseJObj) {
+        jobject linguisticDatabaseJObj,
+        jint maxNbOfRecommendations,
+        jint minScore,
+        jboolean useIndex) {
     return convertCppExceptionsToJavaExceptionsAndReturnTheResult<jobjectArray>(env, [&]() {
-        return protectByMutexWithReturn<jobjectArray>([&] {
-            auto &lingDb = getLingDb(env, linguisticDatabaseJObj);
-            auto &semExp = getSemExp(env, semExpJObj);
-            auto &recommendationContainer = _getRecommendationsContainer(env,
-                                                                         recommendationsFinderJObj);
-            std::map<int, std::set<std::string>> recommendations;
-            getRecommendations(recommendations, 100, *semExp, recommendationContainer, lingDb);
-
-            std::list<std::string> recommendationsToReturn;
-            std::size_t maxNbOfRecommendations = 3;
-            auto itSetOfRecomendations = recommendations.end();
-            while (itSetOfRecomendations != recommendations.begin()) {
-                --itSetOfRecomendations;
-                for (const auto &currRecommendation : itSetOfRecomendations->second) {
-                    --maxNbOfRecommendations;
-                    if (maxNbOfRecommendations > 0)
-                        recommendationsToReturn.emplace_back(currRecommendation);
-                    else
-                        break;
-                }
+        auto lingDbPtr = getLingDb(env, linguisticDatabaseJObj);
+        auto &lingDb = *lingDbPtr;
+        auto semExpPtr = getSemExp(env, semExpJObj);
+        auto &semExp = *semExpPtr;
+        auto maxSize = static_cast<std::size_t>(std::max(maxNbOfRecommendations, 0));
+        TopRecommendations topRecommendations(maxSize, minScore);
+        if (useIndex) {
+            auto indexFeatures = _indexFeatures(*semExp);
+            ReadLockedObject<RecommendationsFinder> recommendationsFinder(
+                    _getRecommendationsFinder(env, recommendationsFinderJObj));
+            recommendationsFinder->index.findTop(indexFeatures, topRecommendations);
+        } else {
+            std::map<int, std::set<std::string>> scoreToRecommendations;
+            {
+                ReadLockedObject<RecommendationsFinder> recommendationsFinder(
+                        _getRecommendationsFinder(env, recommendationsFinderJObj));
+                getRecommendations(scoreToRecommendations, std::max(maxSize, _minNbOfCandidates), *semExp,
+                                   recommendationsFinder->container, lingDb);
             }
+            // From the best score, so the selection stops at the first score that cannot be kept
+            for (auto it = scoreToRecommendations.rbegin(); it != scoreToRecommendations.rend(); ++it) {
+                if (!topRecommendations.canKeep(it->first))
+                    break;
+                for (const auto &currRecommendation : it->second)
+                    topRecommendations.add(currRecommendation, it->first);
+            }
+        }
+        auto recommendations = topRecommendations.takeSorted();
 
-            jobjectArray result;
-            result = (jobjectArray) env->NewObjectArray(recommendationsToReturn.size(),
-                                                        env->FindClass("java/lang/String"),
-                                                        env->NewStringUTF(""));
-
-            jsize arrayElt = 0;
-            for (const auto& currRecommendation : recommendationsToReturn)
-                env->SetObjectArrayElement(result, arrayElt++,
-                                           env->NewStringUTF(currRecommendation.c_str()));
-            return result;
-        });
+        const auto &javaBindings = getJavaBindings();
+        auto result = env->NewObjectArray(static_cast<jsize>(recommendations.size()),
+                                          javaBindings.recommendationClass, nullptr);
+        for (std::size_t i = 0; i < recommendations.size(); ++i) {
+            auto idJStr = env->NewStringUTF(recommendations[i].id.c_str());
+            auto recommendationJObj = env->NewObject(javaBindings.recommendationClass,
+                                                     javaBindings.recommendationConstructor,
+                                                     idJStr, static_cast<jint>(recommendations[i].score));
+            env->SetObjectArrayElement(result, static_cast<jsize>(i), recommendationJObj);
+            env->DeleteLocalRef(recommendationJObj);
+            env->DeleteLocalRef(idJStr);
+        }
+        return result;
     }, nullptr);
 }
@@ -1,10 +1,14 @@
 #include "semanticenumsindexes.hpp"
 #include "jobjectstocpptypes.hpp"
+#include "javabindings.hpp"
+#include <memory>
 #include <sstream>
 
 using namespace onsem;
 
 namespace {
+    std::unique_ptr<const SemanticEnumsIndexes> _semanticEnumsIndexes;
+
     static const std::map<std::string, SemanticVerbTense> _javaToCppPartOfVerbTenses{
             {"PRESENT",         SemanticVerbTense::PRESENT},
             {"PUNCTUALPRESENT", SemanticVerbTense::PUNCTUALPRESENT},
@@ -91,7 +95,7 @@ namespace {
         auto enumClassNameReturnTypeStr = enumClassNameReturnTypeSs.str();
         const char *enumClassNameReturnType = enumClassNameReturnTypeStr.c_str();
         jclass enumClass = env->FindClass(enumClassName.c_str());
-        jmethodID ordinalFun = env->GetMethodID(enumClass, "ordinal", "()I");
+        jmethodID ordinalFun = getJavaBindings().enumOrdinalMethod;
 
         auto map = std::map<int, ENUM_TYPE>();
         for (const auto &currElt : pJavaEnumValuesToCppEnumValues)
@@ -110,6 +114,7 @@ namespace {
             }
             res[currentIndex++] = currElt.second;
         }
+        env->DeleteLocalRef(enumClass);
         return res;
     }
 }
@@ -168,10 +173,10 @@ SemanticEnumsIndexes::SemanticEnumsIndexes(JNIEnv *env)
                                             _javaToCppJavaOperatorEnum)) {
 }
 
-const SemanticEnumsIndexes &getSemanticEnumsIndexes(JNIEnv *env) {
-    static std::map<JNIEnv *, SemanticEnumsIndexes> envToIndexes;
-    auto it = envToIndexes.find(env);
-    if (it != envToIndexes.end())
-        return it->second;
-    return envToIndexes.emplace(env, SemanticEnumsIndexes(env)).first->second;
+void initSemanticEnumsIndexes(JNIEnv *env) {
+    _semanticEnumsIndexes = std::make_unique<const SemanticEnumsIndexes>(env);
+}
+
+const SemanticEnumsIndexes &getSemanticEnumsIndexes() {
+    return *_semanticEnumsIndexes;
 }
\ No newline at end of file
@@ -55,6 +55,9 @@ struct SemanticEnumsIndexes {
     std::vector<JavaOperatorEnum> javaOrdinalJavaOperatorEnumToCpp;
 };
 
-const SemanticEnumsIndexes &getSemanticEnumsIndexes(JNIEnv *env);
+/// Called only once, in JNI_OnLoad.
+void initSemanticEnumsIndexes(JNIEnv *env);
+
+const SemanticEnumsIndexes &getSemanticEnumsIndexes();
 
 #endif // SEMANTIC_ANDROID_SEMANTICENUMSINDEXES_HPP
@@ -1,5 +1,7 @@
 #include "semanticexpression-jni.hpp"
 #include <sstream>
+#include <string>
+#include <vector>
 #include <onsem/texttosemantic/dbtype/textprocessingcontext.hpp>
 #include <onsem/semantictotext/semanticconverter.hpp>
 #include <onsem/semantictotext/semexpoperators.hpp>
@@ -11,38 +13,94 @@
 #include "textprocessingcontext-jni.hpp"
 #include "semanticmemory-jni.hpp"
 #include "semanticenumsindexes.hpp"
+#include "objectregistry.hpp"
+#include "javabindings.hpp"
+#include "paralleltasks.hpp"
+#include "parsecache.hpp"
+#include "semanticserialization.hpp"
+#include "synthesiscache.hpp"
 
 using namespace onsem;
 
 namespace {
-    std::map<jint, UniqueSemanticExpression> _idToUniqueSemanticExpression;
+    ObjectRegistry<UniqueSemanticExpression> _idToUniqueSemanticExpression("semantic expression");
 
     jobject _semanticExpressionIdToJobject(JNIEnv *env, jint semExpId) {
-        jclass semanticExperssionClass = env->FindClass(
-                "com/onsem/SemanticExpression");
-        jmethodID semanticExpressionConstructor =
-                env->GetMethodID(semanticExperssionClass, "<init>", "(I)V");
-        return env->NewObject(semanticExperssionClass, semanticExpressionConstructor, semExpId);
+        const auto &javaBindings = getJavaBindings();
+        return env->NewObject(javaBindings.semanticExpressionClass, javaBindings.semanticExpressionConstructor,
+                              semExpId);
     }
 
-    const UniqueSemanticExpression &_getSemExp(int pSemExpId) {
-        auto it = _idToUniqueSemanticExpression.find(pSemExpId);
-        if (it == _idToUniqueSemanticExpression.end()) {
-            std::stringstream ssErrorMessage;
-            ssErrorMessage << "wrong semantic expression id: " << pSemExpId;
-            throw std::runtime_error(ssErrorMessage.str());
+    /// Parse a text, or get it from the parse cache of the linguistic database if it has one.
+    UniqueSemanticExpression _textToContextualSemExp(const std::shared_ptr<ParseCache> &pParseCache,
+                                                     const std::string &pText,
+                                                     const TextProcessingContext &pTextProcContext,
+                                                     const std::string &pTextProcContextKey,
+                                                     SemanticSourceEnum pSource,
+                                                     const linguistics::LinguisticDatabase &pLingDb) {
+        auto parse = [&]() {
+            return converter::textToContextualSemExp(pText, pTextProcContext, pSource, pLingDb);
+        };
+        if (!pParseCache)
+            return parse();
+        // The normalized text has no line break, so the key is not ambiguous
+        auto key = std::to_string(static_cast<int>(pSource)) + '\n' + normalizeTextForParseCache(pText) +
+                   '\n' + pTextProcContextKey;
+        return pParseCache->getOrParse(key, parse);
+    }
+
+    jstring _semanticExpressionToText(JNIEnv *env,
+                                      UniqueSemanticExpression pSemExp,
+                                      jobject pLocale,
+                                      jobject pSemanticMemoryJObj,
+                                      jobject pLinguisticDatabaseJObj) {
+        auto language = toLanguage(env, pLocale);
+        auto lingDbPtr = getLingDb(env, pLinguisticDatabaseJObj, language);
+        auto &lingDb = *lingDbPtr;
+        auto textProcFromRobot = TextProcessingContext::getTextProcessingContextFromRobot(
+                language);
+        textProcFromRobot.vouvoiement = true;
+        std::string res;
+        {
+            auto semanticMemory = readSemanticMemory(env, pSemanticMemoryJObj);
+            auto *synthesisCache = semanticMemory.synthesisCache();
+            std::string synthesisCacheKey;
+            if (synthesisCache != nullptr) {
+                synthesisCacheKey = "text\n" + semanticLanguageEnum_toLegacyStr(language) + "\nvouvoiement\n" +
+                                    std::to_string(semExpStructuralHash(*pSemExp));
+                if (synthesisCache->get(synthesisCacheKey, semanticMemory.knowledgeGeneration(), res))
+                    return env->NewStringUTF(res.c_str());
+            }
+            converter::semExpToText(res, std::move(pSemExp), textProcFromRobot, false, *semanticMemory,
+                                    lingDb, nullptr);
+            if (synthesisCache != nullptr)
+                synthesisCache->put(synthesisCacheKey, semanticMemory.knowledgeGeneration(), res);
         }
-        return it->second;
+        return env->NewStringUTF(res.c_str());
     }
 }
 
-const UniqueSemanticExpression &getSemExp(JNIEnv *env, jobject pSemExp) {
-    return _getSemExp(toDisposableWithIdId(env, pSemExp));
+std::shared_ptr<const UniqueSemanticExpression> getSemExp(JNIEnv *env, jobject pSemExp) {
+    return _idToUniqueSemanticExpression.get(toDisposableWithIdId(env, pSemExp));
+}
+
+UniqueSemanticExpression takeSemExp(JNIEnv *env, jobject pSemExp) {
+    auto semExpId = toDisposableWithIdId(env, pSemExp);
+    auto semExpPtr = _idToUniqueSemanticExpression.remove(semExpId);
+    if (!semExpPtr) {
+        std::stringstream ssErrorMessage;
+        ssErrorMessage << "wrong semantic expression id: " << semExpId;
+        throw std::runtime_error(ssErrorMessage.str());
+    }
+    // Nobody can get the expression from the registry anymore, so if we have the only reference it cannot change
+    if (semExpPtr.use_count() == 1)
+        return std::move(*semExpPtr);
+    return (*semExpPtr)->clone();
 }
 
 jobject semanticExpressionToJobject(JNIEnv *env, UniqueSemanticExpression pSemExp) {
-    jint newId = findMissingKey(_idToUniqueSemanticExpression);
-    _idToUniqueSemanticExpression.emplace(newId, std::move(pSemExp));
+    jint newId = _idToUniqueSemanticExpression.add(
+            std::make_shared<UniqueSemanticExpression>(std::move(pSemExp)));
     return _semanticExpressionIdToJobject(env, newId);
 }
 
@@ -63,16 +121,70 @@ Java_com_onsem_SemanticExpressionKt_textToSemanticExpression(
         jobject semanticMemoryJObj,
         jobject linguisticDatabaseJObj) {
     return convertCppExceptionsToJavaExceptionsAndReturnTheResult<jobject>(env, [&]() {
-        return protectByMutexWithReturn<jobject>([&]() {
         auto text = toString(env, jtext);
-            auto &lingDb = getLingDb(env, linguisticDatabaseJObj);
-            auto &semanticMemory = getSemanticMemory(env, semanticMemoryJObj);
-            auto &textProcessingContext = getTextProcessingContext(env, textProcessingContextJobj);
-            auto sourceEnum = toSourceEnum(env, sourceJobj, getSemanticEnumsIndexes(env));
-            auto semExp = converter::textToContextualSemExp(text, textProcessingContext, sourceEnum, lingDb);
-            memoryOperation::mergeWithContext(semExp, semanticMemory, lingDb);
-            return semanticExpressionToJobject(env, std::move(semExp));
+        auto textProcessingContextPtr = getTextProcessingContext(env, textProcessingContextJobj);
+        auto lingDbPtr = getLingDb(env, linguisticDatabaseJObj, textProcessingContextPtr->langType);
+        auto &lingDb = *lingDbPtr;
+        auto sourceEnum = toSourceEnum(env, sourceJobj, getSemanticEnumsIndexes());
+        auto semExp = _textToContextualSemExp(getParseCache(env, linguisticDatabaseJObj), text,
+                                              *textProcessingContextPtr,
+                                              getTextProcessingContextKey(env, textProcessingContextJobj),
+                                              sourceEnum, lingDb);
+        // The parsing is pure, so the memory is only locked for the merge with its context
+        {
+            auto semanticMemory = readSemanticMemory(env, semanticMemoryJObj);
+            memoryOperation::mergeWithContext(semExp, *semanticMemory, lingDb);
+        }
+        return semanticExpressionToJobject(env, std::move(semExp));
+    }, nullptr);
+}
+
+
+extern "C"
+JNIEXPORT jobjectArray JNICALL
+Java_com_onsem_SemanticExpressionKt_textsToSemanticExpressions(
+        JNIEnv *env, jclass /*clazz*/, jobjectArray jtexts,
+        jobject textProcessingContextJobj,
+        jobject sourceJobj,
+        jobject semanticMemoryJObj,
+        jobject linguisticDatabaseJObj) {
+    return convertCppExceptionsToJavaExceptionsAndReturnTheResult<jobjectArray>(env, [&]() {
+        const jsize nbOfTexts = env->GetArrayLength(jtexts);
+        std::vector<std::string> texts;
+        texts.reserve(nbOfTexts);
+        for (jsize i = 0; i < nbOfTexts; ++i) {
+            auto jtext = static_cast<jstring>(env->GetObjectArrayElement(jtexts, i));
+            texts.emplace_back(toString(env, jtext));
+            env->DeleteLocalRef(jtext);
+        }
+        auto textProcessingContextPtr = getTextProcessingContext(env, textProcessingContextJobj);
+        const auto &textProcessingContext = *textProcessingContextPtr;
+        auto lingDbPtr = getLingDb(env, linguisticDatabaseJObj, textProcessingContext.langType);
+        const auto &lingDb = *lingDbPtr;
+        auto sourceEnum = toSourceEnum(env, sourceJobj, getSemanticEnumsIndexes());
+        auto parseCache = getParseCache(env, linguisticDatabaseJObj);
+        auto textProcessingContextKey = getTextProcessingContextKey(env, textProcessingContextJobj);
+
+        // The texts are independent, so they are parsed in parallel
+        std::vector<UniqueSemanticExpression> semExps(texts.size());
+        runInParallel(texts.size(), getNbOfWorkerThreads(), [&](std::size_t pTextIndex) {
+            semExps[pTextIndex] = _textToContextualSemExp(parseCache, texts[pTextIndex], textProcessingContext,
+                                                          textProcessingContextKey, sourceEnum, lingDb);
         });
+        // But the merges with the context are done in the order of the texts
+        {
+            auto semanticMemory = readSemanticMemory(env, semanticMemoryJObj);
+            for (auto &currSemExp : semExps)
+                memoryOperation::mergeWithContext(currSemExp, *semanticMemory, lingDb);
+        }
+
+        auto result = env->NewObjectArray(nbOfTexts, getJavaBindings().semanticExpressionClass, nullptr);
+        for (jsize i = 0; i < nbOfTexts; ++i) {
+            auto semExpJObj = semanticExpressionToJobject(env, std::move(semExps[i]));
+            env->SetObjectArrayElement(result, i, semExpJObj);
+            env->DeleteLocalRef(semExpJObj);
+        }
+        return result;
     }, nullptr);
 }
 
@@ -86,21 +198,24 @@ Java_com_onsem_SemanticExpressionKt_semanticExpressionToText(
         jobject semanticMemoryJObj,
         jobject linguisticDatabaseJObj) {
     return convertCppExceptionsToJavaExceptionsAndReturnTheResult<jstring>(env, [&]() {
-        return protectByMutexWithReturn<jstring>([&]() {
-
-            auto &lingDb = getLingDb(env, linguisticDatabaseJObj);
-            auto &semanticMemory = getSemanticMemory(env, semanticMemoryJObj);
-            auto language = toLanguage(env, locale);
-            auto &semExp = getSemExp(env, semanticExpressionJobj);
-            auto textProcFromRobot = TextProcessingContext::getTextProcessingContextFromRobot(
-                    language);
-            textProcFromRobot.vouvoiement = true;
-            std::string res;
-            converter::semExpToText(res, semExp->clone(), textProcFromRobot, false, semanticMemory,
-                                    lingDb, nullptr);
+        auto semExpPtr = getSemExp(env, semanticExpressionJobj);
+        return _semanticExpressionToText(env, (*semExpPtr)->clone(), locale, semanticMemoryJObj,
+                                         linguisticDatabaseJObj);
+    }, nullptr);
+}
 
-            return env->NewStringUTF(res.c_str());
-        });
+
+extern "C"
+JNIEXPORT jstring JNICALL
+Java_com_onsem_SemanticExpressionKt_semanticExpressionToTextAndConsumeCpp(
+        JNIEnv *env, jclass /*clazz*/,
+        jobject semanticExpressionJobj,
+        jobject locale,
+        jobject semanticMemoryJObj,
+        jobject linguisticDatabaseJObj) {
+    return convertCppExceptionsToJavaExceptionsAndReturnTheResult<jstring>(env, [&]() {
+        return _semanticExpressionToText(env, takeSemExp(env, semanticExpressionJobj), locale,
+                                         semanticMemoryJObj, linguisticDatabaseJObj);
     }, nullptr);
 }
 
@@ -109,9 +224,7 @@ extern "C"
 JNIEXPORT void JNICALL
 Java_com_onsem_SemanticExpressionKt_deleteSemanticExpression(
         JNIEnv *env, jclass /*clazz*/, jint semanticexpressionId) {
-    protectByMutex([&]() {
-        _idToUniqueSemanticExpression.erase(semanticexpressionId);
-    });
+    _idToUniqueSemanticExpression.remove(semanticexpressionId);
 }
 
 
@@ -2,6 +2,7 @@
 #define SEMANTIC_ANDROID_SEMANTICEXPRESSION_JNI_HPP
 
 #include <cstddef>
+#include <memory>
 #include <jni.h>
 #include <onsem/common/utility/unique_propagate_const.hpp>
 
@@ -9,7 +10,14 @@ namespace onsem {
     struct UniqueSemanticExpression;
 }
 
-const onsem::UniqueSemanticExpression &getSemExp(JNIEnv *env, jobject pSemExp);
+/// The semantic expressions are never modified after their creation, so the returned pointer is only to keep it alive.
+std::shared_ptr<const onsem::UniqueSemanticExpression> getSemExp(JNIEnv *env, jobject pSemExp);
+/**
+ * Remove a semantic expression from the registry and return it, so the java handle is not usable anymore.
+ * It avoids a clone for the operations that consume the expression.
+ * (the expression is only cloned if another thread is still reading it)
+ */
+onsem::UniqueSemanticExpression takeSemExp(JNIEnv *env, jobject pSemExp);
 jobject semanticExpressionPtrToJobject(JNIEnv *env, onsem::mystd::unique_propagate_const<onsem::UniqueSemanticExpression> pSemExpPtr);
 
 
@@ -1,4 +1,7 @@
 #include "semanticmemory-jni.hpp"
+#include <algorithm>
+#include <atomic>
+#include <set>
 #include <sstream>
 #include <onsem/semantictotext/semanticmemory/semantictracker.hpp>
 #include <onsem/semantictotext/semanticmemory/semanticmemory.hpp>
@@ -10,43 +13,137 @@
 #include "linguisticdatabase-jni.hpp"
 #include "semanticenumsindexes.hpp"
 #include "semanticexpression-jni.hpp"
+#include "javabindings.hpp"
+#include "memorysnapshot.hpp"
+#include "memoryjournal.hpp"
+#include "synthesiscache.hpp"
 
 using namespace onsem;
 
 
 struct SemanticMemoryWithTrackers {
     SemanticMemory semanticMemory;
+    std::shared_ptr<LockableObject<SemanticMemoryWithTrackers>> subMemory;
     std::list<std::shared_ptr<SemanticTracker>> semanticMemoryTrackers;
     std::set<jint> trackersId;
     std::list<jint> reachedValuesFromTrackerCache;
     mystd::observable::Connection infActionAddedConnection;
     std::map<std::string, std::string> varToValue;
     std::list<std::string> factsToAdd;
+    /// Value of the knowledge clock at the last change of the knowledge of this memory or of its links.
+    std::uint64_t knowledgeEpoch = 0;
+    std::unique_ptr<SynthesisCache> synthesisCache;
+    /// Last member, so that its thread stops before the destruction of the memory.
+    /// (the mutex of the LockableObject that contains this object is destroyed after it, cf LockableObject)
+    std::unique_ptr<MemoryJournal> journal;
 };
 
 
 namespace {
-    std::map<jint, SemanticMemoryWithTrackers> _idToSemanticMemoryWithTrackers;
-
-    SemanticMemoryWithTrackers &_getSemanticMemoryWithTrackers(int pSemanticMemoryId) {
-        auto it = _idToSemanticMemoryWithTrackers.find(pSemanticMemoryId);
-        if (it == _idToSemanticMemoryWithTrackers.end()) {
-            std::stringstream ssErrorMessage;
-            ssErrorMessage << "wrong semantic memory id: " << pSemanticMemoryId;
-            throw std::runtime_error(ssErrorMessage.str());
-        }
-        return it->second;
+    ObjectRegistry<LockableObject<SemanticMemoryWithTrackers>> _idToSemanticMemoryWithTrackers("semantic memory");
+
+    /// Shared by all the memories, so that a new epoch is greater than the epochs of all the memories.
+    std::atomic<std::uint64_t> _knowledgeClock(0);
+
+    /// Only one link of a sub memory at a time, so that two links in opposite directions
+    /// cannot wait for the lock of the memory that the other one holds.
+    std::mutex _linkMutex;
+
+    // The sub memories are always locked after the memory that use them, so the lock order is always the same
+    void _lockTheSubMemories(const LockableObject<SemanticMemoryWithTrackers> &pMemory,
+                             std::list<std::shared_lock<std::shared_mutex>> &pSubMemoryLocks) {
+        for (auto *subMemoryPtr = pMemory.object.subMemory.get(); subMemoryPtr != nullptr;
+             subMemoryPtr = subMemoryPtr->object.subMemory.get())
+            pSubMemoryLocks.emplace_back(subMemoryPtr->mutex);
     }
 
-    SemanticMemory &_getSemanticMemory(int pSemanticMemoryId) {
-        return _getSemanticMemoryWithTrackers(pSemanticMemoryId).semanticMemory;
+    std::uint64_t _knowledgeGeneration(const LockableObject<SemanticMemoryWithTrackers> &pMemory) {
+        // A change of a memory of the chain, or of the chain itself (cf linkASubMemory), gives a new epoch
+        // to a memory of the chain, and this epoch is greater than all the previous ones, so the maximum increases
+        std::uint64_t res = 0;
+        for (auto *memoryPtr = &pMemory; memoryPtr != nullptr; memoryPtr = memoryPtr->object.subMemory.get())
+            res = std::max(res, memoryPtr->object.knowledgeEpoch);
+        return res;
     }
+}
+
+
+ReadLockedSemanticMemory::ReadLockedSemanticMemory(
+        std::shared_ptr<LockableObject<SemanticMemoryWithTrackers>> pMemory)
+        : _memory(std::move(pMemory)),
+          _lock(_memory->mutex),
+          _subMemoryLocks() {
+    _lockTheSubMemories(*_memory, _subMemoryLocks);
+}
+
+const SemanticMemory &ReadLockedSemanticMemory::operator*() const {
+    return _memory->object.semanticMemory;
+}
+
+const SemanticMemory *ReadLockedSemanticMemory::operator->() const {
+    return &_memory->object.semanticMemory;
+}
+
+SynthesisCache *ReadLockedSemanticMemory::synthesisCache() const {
+    return _memory->object.synthesisCache.get();
+}
+
+std::uint64_t ReadLockedSemanticMemory::knowledgeGeneration() const {
+    return _knowledgeGeneration(*_memory);
+}
 
+
+WriteLockedSemanticMemory::WriteLockedSemanticMemory(
+        std::shared_ptr<LockableObject<SemanticMemoryWithTrackers>> pMemory,
+        bool pCanChangeTheKnowledge)
+        : _memory(std::move(pMemory)),
+          _lock(_memory->mutex),
+          _subMemoryLocks() {
+    if (pCanChangeTheKnowledge)
+        _memory->object.knowledgeEpoch = ++_knowledgeClock;
+    _lockTheSubMemories(*_memory, _subMemoryLocks);
+}
+
+SemanticMemory &WriteLockedSemanticMemory::operator*() const {
+    return _memory->object.semanticMemory;
+}
+
+SemanticMemory *WriteLockedSemanticMemory::operator->() const {
+    return &_memory->object.semanticMemory;
+}
+
+SemanticMemoryWithTrackers &WriteLockedSemanticMemory::withTrackers() const {
+    return _memory->object;
+}
+
+MemoryJournal *WriteLockedSemanticMemory::journal() const {
+    return _memory->object.journal.get();
+}
+
+void WriteLockedSemanticMemory::requestCompaction() const {
+    if (auto *journal = _memory->object.journal.get())
+        journal->requestCompaction();
+}
+
+SynthesisCache *WriteLockedSemanticMemory::synthesisCache() const {
+    return _memory->object.synthesisCache.get();
+}
+
+std::uint64_t WriteLockedSemanticMemory::knowledgeGeneration() const {
+    return _knowledgeGeneration(*_memory);
 }
 
 
-SemanticMemory &getSemanticMemory(JNIEnv *env, jobject pSemanticMemory) {
-    return _getSemanticMemory(toDisposableWithIdId(env, pSemanticMemory));
+ReadLockedSemanticMemory readSemanticMemory(JNIEnv *env, jobject pSemanticMemory) {
+    return ReadLockedSemanticMemory(
+            _idToSemanticMemoryWithTrackers.get(toDisposableWithIdId(env, pSemanticMemory)));
+}
+
+WriteLockedSemanticMemory writeSemanticMemory(JNIEnv *env, jobject pSemanticMemory,
+                                              bool pCanChangeTheKnowledge) {
+    return WriteLockedSemanticMemory(
+            _idToSemanticMemoryWithTrackers.get(toDisposableWithIdId(env, pSemanticMemory)),
+            pCanChangeTheKnowledge);
 }
 
 extern "C"
@@ -54,22 +151,109 @@ JNIEXPORT jint JNICALL
 Java_com_onsem_SemanticMemoryKt_newMemory(
         JNIEnv *env, jclass /*clazz*/) {
     return convertCppExceptionsToJavaExceptionsAndReturnTheResult<jint>(env, [&]() {
-        return protectByMutexWithReturn<jint>([&]() {
-            jint newLocalMemory = findMissingKey(_idToSemanticMemoryWithTrackers);
-            auto& newMemTracker = _idToSemanticMemoryWithTrackers[newLocalMemory];
-            return newLocalMemory;
-        });
+        return _idToSemanticMemoryWithTrackers.add(
+                std::make_shared<LockableObject<SemanticMemoryWithTrackers>>());
+    }, -1);
+}
+
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_onsem_SemanticMemoryKt_saveMemorySnapshotCpp(
+        JNIEnv *env, jclass /*clazz*/, jint semanticMemoryId, jstring snapshotFilenameJStr) {
+    convertCppExceptionsToJavaExceptions(env, [&]() {
+        auto snapshotFilename = toString(env, snapshotFilenameJStr);
+        MemorySnapshot snapshot;
+        {
+            ReadLockedSemanticMemory semanticMemory(_idToSemanticMemoryWithTrackers.get(semanticMemoryId));
+            snapshot = makeMemorySnapshot(*semanticMemory);
+        }
+        // The file is written without the lock of the memory
+        writeMemorySnapshot(snapshotFilename, snapshot);
+    });
+}
+
+
+extern "C"
+JNIEXPORT jint JNICALL
+Java_com_onsem_SemanticMemoryKt_loadMemorySnapshotCpp(
+        JNIEnv *env, jclass /*clazz*/, jstring snapshotFilenameJStr, jobject linguisticDatabaseJObj) {
+    return convertCppExceptionsToJavaExceptionsAndReturnTheResult<jint>(env, [&]() {
+        auto lingDbPtr = getLingDb(env, linguisticDatabaseJObj);
+        // The memory is not in the registry yet, so no other thread can use it during the loading
+        auto semanticMemory = std::make_shared<LockableObject<SemanticMemoryWithTrackers>>();
+        restoreMemorySnapshot(readMemorySnapshot(toString(env, snapshotFilenameJStr)),
+                              semanticMemory->object.semanticMemory, *lingDbPtr);
+        return _idToSemanticMemoryWithTrackers.add(std::move(semanticMemory));
+    }, -1);
+}
+
+
+extern "C"
+JNIEXPORT jint JNICALL
+Java_com_onsem_SemanticMemoryKt_openMemoryWithJournalCpp(
+        JNIEnv *env, jclass /*clazz*/, jstring snapshotFilenameJStr, jstring journalFilenameJStr,
+        jlong compactionIntervalMs, jobject linguisticDatabaseJObj) {
+    return convertCppExceptionsToJavaExceptionsAndReturnTheResult<jint>(env, [&]() {
+        auto snapshotFilename = toString(env, snapshotFilenameJStr);
+        auto journalFilename = toString(env, journalFilenameJStr);
+        auto lingDbPtr = getLingDb(env, linguisticDatabaseJObj);
+        auto semanticMemory = std::make_shared<LockableObject<SemanticMemoryWithTrackers>>();
+        auto &semanticMemoryWithTrackers = semanticMemory->object;
+        auto generation = MemoryJournal::restore(snapshotFilename, journalFilename,
+                                                 semanticMemoryWithTrackers.semanticMemory, *lingDbPtr);
+        semanticMemoryWithTrackers.journal = std::make_unique<MemoryJournal>(
+                std::move(snapshotFilename), std::move(journalFilename), generation,
+                std::chrono::milliseconds(compactionIntervalMs), semanticMemory->mutex,
+                semanticMemoryWithTrackers.semanticMemory);
+        return _idToSemanticMemoryWithTrackers.add(std::move(semanticMemory));
     }, -1);
 }
 
 
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_onsem_SemanticMemoryKt_useSynthesisCache(
+        JNIEnv *env, jclass /*clazz*/, jint semanticMemoryId, jint maxNbOfTexts) {
+    convertCppExceptionsToJavaExceptions(env, [&]() {
+        WriteLockedSemanticMemory semanticMemory(_idToSemanticMemoryWithTrackers.get(semanticMemoryId), false);
+        semanticMemory.withTrackers().synthesisCache = maxNbOfTexts > 0 ?
+                std::make_unique<SynthesisCache>(static_cast<std::size_t>(maxNbOfTexts)) : nullptr;
+    });
+}
+
+
 extern "C"
 JNIEXPORT void JNICALL
 Java_com_onsem_SemanticMemoryKt_linkASubMemory(
         JNIEnv *env, jclass /*clazz*/, jint mainSemanticId, jint subSemanticId) {
-    protectByMutex([&]() {
-        _idToSemanticMemoryWithTrackers[mainSemanticId].semanticMemory.memBloc.subBlockPtr =
-                &_idToSemanticMemoryWithTrackers[subSemanticId].semanticMemory.memBloc;
+    convertCppExceptionsToJavaExceptions(env, [&]() {
+        auto subMemory = _idToSemanticMemoryWithTrackers.get(subSemanticId);
+        std::lock_guard<std::mutex> linkLock(_linkMutex);
+        // Declared before the lock of the main memory, so that the previous sub memory is destroyed
+        // after the release of the lock that the main memory holds on it
+        std::shared_ptr<LockableObject<SemanticMemoryWithTrackers>> previousSubMemory;
+        // The write lock gives a new knowledge epoch to the main memory, because its sub memories change
+        WriteLockedSemanticMemory mainMemory(_idToSemanticMemoryWithTrackers.get(mainSemanticId));
+        // The memories of the current chain are already locked by the main memory
+        std::set<const LockableObject<SemanticMemoryWithTrackers> *> lockedMemories;
+        for (auto *memoryPtr = mainMemory.withTrackers().subMemory.get(); memoryPtr != nullptr;
+             memoryPtr = memoryPtr->object.subMemory.get())
+            lockedMemories.insert(memoryPtr);
+        // The new chain is read under its locks, and the main memory is checked before each lock
+        std::list<std::shared_lock<std::shared_mutex>> newSubMemoryLocks;
+        for (auto *memoryPtr = subMemory.get(); memoryPtr != nullptr;
+             memoryPtr = memoryPtr->object.subMemory.get()) {
+            if (&memoryPtr->object == &mainMemory.withTrackers())
+                throw std::runtime_error("linking this sub memory would create a cycle of memories");
+            if (lockedMemories.count(memoryPtr) == 0)
+                newSubMemoryLocks.emplace_back(memoryPtr->mutex);
+        }
+        mainMemory->memBloc.subBlockPtr = &subMemory->object.semanticMemory.memBloc;
+        previousSubMemory = std::move(mainMemory.withTrackers().subMemory);
+        mainMemory.withTrackers().subMemory = std::move(subMemory);
+        // The next records would not be replayed with the same sub memory
+        mainMemory.requestCompaction();
     });
 }
 
@@ -77,10 +261,12 @@ extern "C"
 JNIEXPORT void JNICALL
 Java_com_onsem_SemanticMemoryKt_setCurrentUserId(
         JNIEnv *env, jclass /*clazz*/, jint semanticMemoryId, jstring jcurrentUserId) {
-    protectByMutex([&]() {
+    convertCppExceptionsToJavaExceptions(env, [&]() {
         auto currentUserId = toString(env, jcurrentUserId);
-        _idToSemanticMemoryWithTrackers[semanticMemoryId].semanticMemory.setCurrUserId(
-                currentUserId);
+        WriteLockedSemanticMemory semanticMemory(_idToSemanticMemoryWithTrackers.get(semanticMemoryId));
+        semanticMemory->setCurrUserId(currentUserId);
+        if (auto *journal = semanticMemory.journal())
+            journal->addCurrentUserId(currentUserId);
     });
 }
 
@@ -89,10 +275,9 @@ JNIEXPORT jstring JNICALL
 Java_com_onsem_SemanticMemoryKt_getCurrentUserId(
         JNIEnv *env, jclass /*clazz*/, jint semanticMemoryId) {
     return convertCppExceptionsToJavaExceptionsAndReturnTheResult<jstring>(env, [&]() {
-        return protectByMutexWithReturn<jstring>([&]() {
-            auto userId = _idToSemanticMemoryWithTrackers[semanticMemoryId].semanticMemory.getCurrUserId();
-            return env->NewStringUTF(userId.c_str());
-        });
+        ReadLockedSemanticMemory semanticMemory(_idToSemanticMemoryWithTrackers.get(semanticMemoryId));
+        auto userId = semanticMemory->getCurrUserId();
+        return env->NewStringUTF(userId.c_str());
     }, jstring());
 }
 
@@ -100,8 +285,12 @@ extern "C"
 JNIEXPORT void JNICALL
 Java_com_onsem_SemanticMemoryKt_clearLocalInformationButNotTheSubBlocMemory(
         JNIEnv *env, jclass /*clazz*/, jint semanticMemoryId) {
-    protectByMutex([&]() {
-        _idToSemanticMemoryWithTrackers[semanticMemoryId].semanticMemory.clearLocalInformationButNotTheSubBloc();
+    convertCppExceptionsToJavaExceptions(env, [&]() {
+        WriteLockedSemanticMemory semanticMemory(_idToSemanticMemoryWithTrackers.get(semanticMemoryId));
+        semanticMemory->clearLocalInformationButNotTheSubBloc();
+        // The replay of the previous records would undo the clearing, so a snapshot is needed now
+        if (auto *journal = semanticMemory.journal())
+            journal->requestImmediateCompaction();
     });
 }
 
@@ -111,21 +300,26 @@ Java_com_onsem_SemanticMemoryKt_linkUserIdToFullName(
         JNIEnv *env, jclass /*clazz*/, jint semanticMemoryId,
         jstring juserId, jstring jfullname, jobject linguisticDatabaseJObj) {
     return convertCppExceptionsToJavaExceptionsAndReturnTheResult<jobject>(env, [&]() {
-        return protectByMutexWithReturn<jobject>([&]() {
-            auto userId = toString(env, juserId);
-            auto fullname = toString(env, jfullname);
-            std::istringstream fullnameIss(fullname);
-            std::vector<std::string> names{std::istream_iterator<std::string>{fullnameIss},
-                                           std::istream_iterator<std::string>{}};
-            auto &lingDb = getLingDb(env, linguisticDatabaseJObj);
-            auto &semanticMemoryWithTrackers = _getSemanticMemoryWithTrackers(semanticMemoryId);
-            auto &semanticMemory = semanticMemoryWithTrackers.semanticMemory;
-            auto semExp = converter::agentIdWithNameToSemExp(userId, names);
-            memoryOperation::resolveAgentAccordingToTheContext(semExp, semanticMemory, lingDb);
+        auto userId = toString(env, juserId);
+        auto fullname = toString(env, jfullname);
+        std::istringstream fullnameIss(fullname);
+        std::vector<std::string> names{std::istream_iterator<std::string>{fullnameIss},
+                                       std::istream_iterator<std::string>{}};
+        auto lingDbPtr = getLingDb(env, linguisticDatabaseJObj);
+        auto &lingDb = *lingDbPtr;
+        WriteLockedSemanticMemory lockedSemanticMemory(_idToSemanticMemoryWithTrackers.get(semanticMemoryId));
+        auto &semanticMemory = *lockedSemanticMemory;
+        auto semExp = converter::agentIdWithNameToSemExp(userId, names);
+        memoryOperation::resolveAgentAccordingToTheContext(semExp, semanticMemory, lingDb);
+        auto *journal = lockedSemanticMemory.journal();
+        if (journal == nullptr)
             return newExpressionWithLinks(
                     env,
                     memoryOperation::inform(std::move(semExp), semanticMemory, lingDb));
-        });
+        // Only the operations that succeeded are journaled
+        auto expressionWithLinks = memoryOperation::inform(semExp->clone(), semanticMemory, lingDb);
+        journal->addInform(std::move(semExp));
+        return newExpressionWithLinks(env, std::move(expressionWithLinks));
     }, nullptr);
 }
 
@@ -134,16 +328,20 @@ extern "C"
 JNIEXPORT void JNICALL
 Java_com_onsem_SemanticMemoryKt_subscribeToLearnedBehaviors(
         JNIEnv *env, jclass /*clazz*/, jint semanticMemoryId, jobject linguisticDatabaseJObj) {
-    protectByMutex([&]() {
-        auto &semanticMemoryWithTrackers = _getSemanticMemoryWithTrackers(semanticMemoryId);
+    convertCppExceptionsToJavaExceptions(env, [&]() {
+        // Only the callback changes, not the knowledge
+        WriteLockedSemanticMemory lockedSemanticMemory(_idToSemanticMemoryWithTrackers.get(semanticMemoryId), false);
+        auto &semanticMemoryWithTrackers = lockedSemanticMemory.withTrackers();
         auto &semanticMemory = semanticMemoryWithTrackers.semanticMemory;
-        auto &lingDb = getLingDb(env, linguisticDatabaseJObj);
+        // The callback keeps the linguistic database alive because it can be called after the end of this function
+        auto lingDbPtr = getLingDb(env, linguisticDatabaseJObj);
 
         semanticMemoryWithTrackers.infActionAddedConnection.disconnect();
         semanticMemoryWithTrackers.infActionAddedConnection =
                 semanticMemory.memBloc.infActionAdded.connectUnsafe(
-                        [&](intSemId, const GroundedExpWithLinks* pMemorySentencePtr) {
+                        [&semanticMemoryWithTrackers, &semanticMemory, lingDbPtr](intSemId, const GroundedExpWithLinks* pMemorySentencePtr) {
                             if (pMemorySentencePtr != nullptr) {
+                                auto &lingDb = *lingDbPtr;
                                 auto textProcToRobot = TextProcessingContext::getTextProcessingContextToRobot(
                                         SemanticLanguageEnum::FRENCH);
                                 auto textProcFromRobot = TextProcessingContext::getTextProcessingContextFromRobot(
@@ -184,20 +382,20 @@ JNIEXPORT jobjectArray JNICALL
 Java_com_onsem_SemanticMemoryKt_flushFactsToAdd(
         JNIEnv *env, jclass /*clazz*/, jint semanticMemoryId) {
     return convertCppExceptionsToJavaExceptionsAndReturnTheResult<jobjectArray>(env, [&]() {
-        return protectByMutexWithReturn<jobjectArray>([&]() {
-            auto &semanticMemoryWithTrackers = _getSemanticMemoryWithTrackers(semanticMemoryId);
-
-            jobjectArray result;
-            result = (jobjectArray)env->NewObjectArray(semanticMemoryWithTrackers.factsToAdd.size(),
-                                                       env->FindClass("java/lang/String"),
-                                                       env->NewStringUTF(""));
-
-            jsize arrayElt = 0;
-            for (const auto& currReference : semanticMemoryWithTrackers.factsToAdd)
-                env->SetObjectArrayElement(result, arrayElt++, env->NewStringUTF(currReference.c_str()));
-            semanticMemoryWithTrackers.factsToAdd.clear();
-            return result;
-        });
+        // The facts to add are not used to generate the texts
+        WriteLockedSemanticMemory lockedSemanticMemory(_idToSemanticMemoryWithTrackers.get(semanticMemoryId), false);
+        auto &semanticMemoryWithTrackers = lockedSemanticMemory.withTrackers();
+
+        jobjectArray result;
+        result = (jobjectArray)env->NewObjectArray(semanticMemoryWithTrackers.factsToAdd.size(),
+                                                   getJavaBindings().stringClass,
+                                                   env->NewStringUTF(""));
+
+        jsize arrayElt = 0;
+        for (const auto& currReference : semanticMemoryWithTrackers.factsToAdd)
+            env->SetObjectArrayElement(result, arrayElt++, env->NewStringUTF(currReference.c_str()));
+        semanticMemoryWithTrackers.factsToAdd.clear();
+        return result;
     }, nullptr);
 }
 
@@ -207,22 +405,22 @@ JNIEXPORT jobjectArray JNICALL
 Java_com_onsem_SemanticMemoryKt_flushVariablesToValue(
         JNIEnv *env, jclass /*clazz*/, jint semanticMemoryId) {
     return convertCppExceptionsToJavaExceptionsAndReturnTheResult<jobjectArray>(env, [&]() {
-        return protectByMutexWithReturn<jobjectArray>([&]() {
-            auto &semanticMemoryWithTrackers = _getSemanticMemoryWithTrackers(semanticMemoryId);
-
-            jobjectArray result;
-            result = (jobjectArray)env->NewObjectArray(semanticMemoryWithTrackers.varToValue.size() * 2,
-                                                       env->FindClass("java/lang/String"),
-                                                       env->NewStringUTF(""));
-
-            jsize arrayElt = 0;
-            for (const auto& currVarToValue : semanticMemoryWithTrackers.varToValue) {
-                env->SetObjectArrayElement(result, arrayElt++, env->NewStringUTF(currVarToValue.first.c_str()));
-                env->SetObjectArrayElement(result, arrayElt++, env->NewStringUTF(currVarToValue.second.c_str()));
-            }
-            semanticMemoryWithTrackers.varToValue.clear();
-            return result;
-        });
+        // The variables are not used to generate the texts
+        WriteLockedSemanticMemory lockedSemanticMemory(_idToSemanticMemoryWithTrackers.get(semanticMemoryId), false);
+        auto &semanticMemoryWithTrackers = lockedSemanticMemory.withTrackers();
+
+        jobjectArray result;
+        result = (jobjectArray)env->NewObjectArray(semanticMemoryWithTrackers.varToValue.size() * 2,
+                                                   getJavaBindings().stringClass,
+                                                   env->NewStringUTF(""));
+
+        jsize arrayElt = 0;
+        for (const auto& currVarToValue : semanticMemoryWithTrackers.varToValue) {
+            env->SetObjectArrayElement(result, arrayElt++, env->NewStringUTF(currVarToValue.first.c_str()));
+            env->SetObjectArrayElement(result, arrayElt++, env->NewStringUTF(currVarToValue.second.c_str()));
+        }
+        semanticMemoryWithTrackers.varToValue.clear();
+        return result;
     }, nullptr);
 }
 
@@ -230,13 +428,12 @@ extern "C"
 JNIEXPORT void JNICALL
 Java_com_onsem_SemanticMemoryKt_deleteMemory(
         JNIEnv *env, jclass /*clazz*/, jint memoryId) {
-    protectByMutex([&]() {
-        _idToSemanticMemoryWithTrackers.erase(memoryId);
-    });
+    // The memory is freed here or at the end of the last call that is still using it
+    _idToSemanticMemoryWithTrackers.remove(memoryId);
 }
 
 
 // Only for debug to spot a potential leak
 std::size_t getNumberOfSemanticMemoryObjects() {
     return _idToSemanticMemoryWithTrackers.size();
-}
\ No newline at end of file
+}
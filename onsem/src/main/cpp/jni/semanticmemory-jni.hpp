@@ -2,13 +2,82 @@
 #define SEMANTIC_ANDROID_SEMANTICMEMORY_JNI_HPP
 
 #include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <jni.h>
+#include "objectregistry.hpp"
 
 namespace onsem {
     struct SemanticMemory;
 }
+struct SemanticMemoryWithTrackers;
+class MemoryJournal;
+class SynthesisCache;
 
-onsem::SemanticMemory &getSemanticMemory(JNIEnv *env, jobject pSemanticMemory);
+
+/**
+ * Keep a semantic memory alive and hold a shared lock on it during the life of this object.
+ * The sub memories linked to it (cf linkASubMemory) are also locked in read mode.
+ * Only a const access to the memory is given, for the operations that do not modify it.
+ * (the ORDER of the members is important, the locks are released before the memory)
+ */
+class ReadLockedSemanticMemory {
+public:
+    explicit ReadLockedSemanticMemory(std::shared_ptr<LockableObject<SemanticMemoryWithTrackers>> pMemory);
+
+    const onsem::SemanticMemory &operator*() const;
+    const onsem::SemanticMemory *operator->() const;
+    /// The cache of the generated texts, or nullptr if the memory has no cache.
+    /// (the cache has its own mutex, so it can be filled with a read lock)
+    SynthesisCache *synthesisCache() const;
+    /// Version of the knowledge of the memory and of its sub memories.
+    /// It increases when one of them changes and when a sub memory is linked.
+    std::uint64_t knowledgeGeneration() const;
+
+private:
+    std::shared_ptr<LockableObject<SemanticMemoryWithTrackers>> _memory;
+    std::shared_lock<std::shared_mutex> _lock;
+    std::list<std::shared_lock<std::shared_mutex>> _subMemoryLocks;
+};
+
+
+/**
+ * Keep a semantic memory alive and hold an exclusive lock on it during the life of this object.
+ * The sub memories linked to it (cf linkASubMemory) are only locked in read mode.
+ * It gives a new knowledge epoch to the memory, except if the operation cannot change
+ * the knowledge used to generate the texts (e.g. the matching of the triggers or the flush of the facts to add).
+ * (the ORDER of the members is important, the locks are released before the memory)
+ */
+class WriteLockedSemanticMemory {
+public:
+    explicit WriteLockedSemanticMemory(std::shared_ptr<LockableObject<SemanticMemoryWithTrackers>> pMemory,
+                                       bool pCanChangeTheKnowledge = true);
+
+    onsem::SemanticMemory &operator*() const;
+    onsem::SemanticMemory *operator->() const;
+    SemanticMemoryWithTrackers &withTrackers() const;
+    /// The journal where the modifications have to be recorded, or nullptr if the memory has no journal.
+    MemoryJournal *journal() const;
+    /// For the modifications that cannot be recorded in the journal, so that a snapshot contains them.
+    /// (nothing is done if the memory has no journal)
+    void requestCompaction() const;
+    /// The cache of the generated texts, or nullptr if the memory has no cache.
+    SynthesisCache *synthesisCache() const;
+    /// Version of the knowledge of the memory and of its sub memories. (cf ReadLockedSemanticMemory)
+    std::uint64_t knowledgeGeneration() const;
+
+private:
+    std::shared_ptr<LockableObject<SemanticMemoryWithTrackers>> _memory;
+    std::unique_lock<std::shared_mutex> _lock;
+    std::list<std::shared_lock<std::shared_mutex>> _subMemoryLocks;
+};
+
+ReadLockedSemanticMemory readSemanticMemory(JNIEnv *env, jobject pSemanticMemory);
+WriteLockedSemanticMemory writeSemanticMemory(JNIEnv *env, jobject pSemanticMemory,
+                                              bool pCanChangeTheKnowledge = true);
 
 
 // Only for debug to spot a potential leak
@@ -0,0 +1,95 @@
+#include "semanticserialization.hpp"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/info_parser.hpp>
+#include <onsem/texttosemantic/dbtype/semanticexpression/semanticexpression.hpp>
+#include <onsem/semantictotext/semanticmemory/semanticmemory.hpp>
+#include <onsem/semantictotext/serialization.hpp>
+
+using namespace onsem;
+
+namespace {
+    const std::uint64_t _fnvOffsetBasis = 14695981039346656037ULL;
+    const std::uint64_t _fnvPrime = 1099511628211ULL;
+
+    void _hashString(std::uint64_t &pHash, const std::string &pStr) {
+        for (unsigned char currChar : pStr)
+            pHash = (pHash ^ currChar) * _fnvPrime;
+        // The size separates the consecutive strings
+        pHash = (pHash ^ pStr.size()) * _fnvPrime;
+    }
+
+    void _hashTree(std::uint64_t &pHash, const boost::property_tree::ptree &pTree) {
+        _hashString(pHash, pTree.data());
+        for (const auto &currChild : pTree) {
+            _hashString(pHash, currChild.first);
+            _hashTree(pHash, currChild.second);
+        }
+        // The number of children closes the node, so the same nodes at another depth give another hash
+        pHash = (pHash ^ pTree.size()) * _fnvPrime;
+    }
+}
+
+
+std::string semExpToString(const SemanticExpression &pSemExp) {
+    boost::property_tree::ptree semExpTree;
+    serialization::saveSemExp(semExpTree, pSemExp);
+    std::stringstream ss;
+    boost::property_tree::write_info(ss, semExpTree);
+    return ss.str();
+}
+
+
+std::uint64_t semExpStructuralHash(const SemanticExpression &pSemExp) {
+    boost::property_tree::ptree semExpTree;
+    serialization::saveSemExp(semExpTree, pSemExp);
+    std::uint64_t res = _fnvOffsetBasis;
+    _hashTree(res, semExpTree);
+    return res;
+}
+
+
+UniqueSemanticExpression stringToSemExp(const std::string &pSerializedSemExp) {
+    std::stringstream ss(pSerializedSemExp);
+    boost::property_tree::ptree semExpTree;
+    boost::property_tree::read_info(ss, semExpTree);
+    return serialization::loadSemExp(semExpTree);
+}
+
+
+std::string semMemoryToString(const SemanticMemory &pSemMemory) {
+    boost::property_tree::ptree semMemoryTree;
+    serialization::saveSemMemory(semMemoryTree, pSemMemory);
+    std::stringstream ss;
+    boost::property_tree::write_info(ss, semMemoryTree);
+    return ss.str();
+}
+
+
+void stringToSemMemory(const std::string &pSerializedSemMemory,
+                       SemanticMemory &pSemMemory,
+                       const linguistics::LinguisticDatabase &pLingDb) {
+    std::stringstream ss(pSerializedSemMemory);
+    boost::property_tree::ptree semMemoryTree;
+    boost::property_tree::read_info(ss, semMemoryTree);
+    serialization::loadSemMemory(semMemoryTree, pSemMemory, pLingDb);
+}
+
+
+void binaryfile::writeFileAtomically(const std::string &pFilename,
+                                     const std::function<void(std::ostream &)> &pWrite) {
+    const auto tmpFilename = pFilename + ".tmp";
+    {
+        std::ofstream out(tmpFilename, std::ios::binary | std::ios::trunc);
+        if (!out)
+            throw std::runtime_error("cannot write " + tmpFilename);
+        pWrite(out);
+        out.flush();
+        if (!out)
+            throw std::runtime_error("failed to write " + tmpFilename);
+    }
+    if (std::rename(tmpFilename.c_str(), pFilename.c_str()) != 0)
+        throw std::runtime_error("cannot rename " + tmpFilename + " to " + pFilename);
+}
\ No newline at end of file
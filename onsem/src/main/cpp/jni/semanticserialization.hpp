@@ -0,0 +1,73 @@
+#ifndef SEMANTIC_ANDROID_SEMANTICSERIALIZATION_HPP
+#define SEMANTIC_ANDROID_SEMANTICSERIALIZATION_HPP
+
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+
+namespace onsem {
+    namespace linguistics {
+        struct LinguisticDatabase;
+    }
+    struct SemanticExpression;
+    struct UniqueSemanticExpression;
+    struct SemanticMemory;
+}
+
+
+/// Serialize a semantic expression in a string. (with the property tree serialization of onsem)
+std::string semExpToString(const onsem::SemanticExpression &pSemExp);
+
+/// Hash of the structure of a semantic expression, for the keys of the caches.
+/// (the nodes of its property tree serialization are hashed without being written in a text)
+std::uint64_t semExpStructuralHash(const onsem::SemanticExpression &pSemExp);
+
+/// Construct a semantic expression from a string returned by semExpToString.
+onsem::UniqueSemanticExpression stringToSemExp(const std::string &pSerializedSemExp);
+
+/// Serialize the content of a semantic memory in a string. (without its sub memory)
+std::string semMemoryToString(const onsem::SemanticMemory &pSemMemory);
+
+/// Fill a semantic memory from a string returned by semMemoryToString.
+void stringToSemMemory(const std::string &pSerializedSemMemory,
+                       onsem::SemanticMemory &pSemMemory,
+                       const onsem::linguistics::LinguisticDatabase &pLingDb);
+
+
+/**
+ * Helpers to write the binary files of the JNI layer.
+ * The numbers are in the native byte order, because the files are only read by the device that wrote them.
+ */
+namespace binaryfile {
+    inline void writeUint32(std::ostream &pOut, std::uint32_t pValue) {
+        pOut.write(reinterpret_cast<const char *>(&pValue), sizeof(pValue));
+    }
+
+    inline void writeString(std::ostream &pOut, const std::string &pStr) {
+        writeUint32(pOut, static_cast<std::uint32_t>(pStr.size()));
+        pOut.write(pStr.data(), pStr.size());
+    }
+
+    inline std::uint32_t readUint32(std::istream &pIn) {
+        std::uint32_t res = 0;
+        if (!pIn.read(reinterpret_cast<char *>(&res), sizeof(res)))
+            throw std::runtime_error("truncated file");
+        return res;
+    }
+
+    inline std::string readString(std::istream &pIn) {
+        std::string res(readUint32(pIn), '\0');
+        if (!pIn.read(&res[0], res.size()))
+            throw std::runtime_error("truncated file");
+        return res;
+    }
+
+    /// Write a file in a temporary file and then rename it, so that a crash never leaves a partial file.
+    void writeFileAtomically(const std::string &pFilename, const std::function<void(std::ostream &)> &pWrite);
+}
+
+
+#endif // SEMANTIC_ANDROID_SEMANTICSERIALIZATION_HPP
@@ -2,12 +2,12 @@
 #include <onsem/common/utility/string.hpp>
 #include "onsem-jni.h"
 #include "jobjectstocpptypes.hpp"
+#include "objectregistry.hpp"
 
 using namespace onsem;
 
 namespace {
-    std::map<jint, mystd::Replacer> _idToStringReplacer;
-    std::mutex _jniStringReplacerMutex;
+    ObjectRegistry<LockableObject<mystd::Replacer>> _idToStringReplacer("string replacer");
 }
 
 extern "C"
@@ -16,10 +16,8 @@ Java_com_onsem_StringReplacer_00024Companion_newStringReplacer(JNIEnv *env, jobj
                                                                jboolean is_case_sensitive,
                                                                jboolean have_separator_between_words) {
     return convertCppExceptionsToJavaExceptionsAndReturnTheResult<jint>(env, [&]() {
-        std::lock_guard<std::mutex> lock(_jniStringReplacerMutex);
-        jint newId = findMissingKey(_idToStringReplacer);
-        _idToStringReplacer.emplace(newId, mystd::Replacer(is_case_sensitive, have_separator_between_words));
-        return newId;
+        return _idToStringReplacer.add(std::make_shared<LockableObject<mystd::Replacer>>(
+                is_case_sensitive, have_separator_between_words));
     }, -1);
 }
 
@@ -29,11 +27,11 @@ JNIEXPORT void JNICALL
 Java_com_onsem_StringReplacer_addReplacementPattern(JNIEnv *env, jobject thiz,
                                                     jstring pattern_to_search, jstring output) {
     convertCppExceptionsToJavaExceptions(env, [&]() {
-        std::lock_guard<std::mutex> lock(_jniStringReplacerMutex);
-        auto it = _idToStringReplacer.find(toDisposableWithIdId(env, thiz));
-        if (it == _idToStringReplacer.end())
+        auto replacerPtr = _idToStringReplacer.find(toDisposableWithIdId(env, thiz));
+        if (!replacerPtr)
             return;
-        it->second.addReplacementPattern(toString(env, pattern_to_search), toString(env, output));
+        WriteLockedObject<mystd::Replacer> replacer(std::move(replacerPtr));
+        replacer->addReplacementPattern(toString(env, pattern_to_search), toString(env, output));
     });
 }
 
@@ -42,11 +40,11 @@ extern "C"
 JNIEXPORT jstring JNICALL
 Java_com_onsem_StringReplacer_doReplacements(JNIEnv *env, jobject thiz, jstring input) {
     return convertCppExceptionsToJavaExceptionsAndReturnTheResult<jstring>(env, [&]() {
-        std::lock_guard<std::mutex> lock(_jniStringReplacerMutex);
-        auto it = _idToStringReplacer.find(toDisposableWithIdId(env, thiz));
-        if (it == _idToStringReplacer.end())
+        auto replacerPtr = _idToStringReplacer.find(toDisposableWithIdId(env, thiz));
+        if (!replacerPtr)
             return input;
-        return env->NewStringUTF(it->second.doReplacements(toString(env, input)).c_str());
+        ReadLockedObject<mystd::Replacer> replacer(std::move(replacerPtr));
+        return env->NewStringUTF(replacer->doReplacements(toString(env, input)).c_str());
     }, nullptr);
 }
 
@@ -54,6 +52,5 @@ Java_com_onsem_StringReplacer_doReplacements(JNIEnv *env, jobject thiz, jstring
 extern "C"
 JNIEXPORT void JNICALL
 Java_com_onsem_StringReplacer_disposeImplementation(JNIEnv *env, jobject thiz, jint id) {
-    std::lock_guard<std::mutex> lock(_jniStringReplacerMutex);
-    _idToStringReplacer.erase(toDisposableWithIdId(env, thiz));
+    _idToStringReplacer.remove(toDisposableWithIdId(env, thiz));
 }
\ No newline at end of file
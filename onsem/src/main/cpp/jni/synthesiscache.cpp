@@ -0,0 +1,31 @@
+#include "synthesiscache.hpp"
+
+
+SynthesisCache::SynthesisCache(std::size_t pMaxSize)
+        : _keyToText(pMaxSize),
+          _mutex(),
+          _knowledgeGeneration(0) {
+}
+
+
+bool SynthesisCache::get(const std::string &pKey, std::uint64_t pKnowledgeGeneration, std::string &pText) {
+    return _updateKnowledgeGeneration(pKnowledgeGeneration) && _keyToText.get(pKey, pText);
+}
+
+
+void SynthesisCache::put(const std::string &pKey, std::uint64_t pKnowledgeGeneration, std::string pText) {
+    if (_updateKnowledgeGeneration(pKnowledgeGeneration))
+        _keyToText.put(pKey, std::move(pText));
+}
+
+
+bool SynthesisCache::_updateKnowledgeGeneration(std::uint64_t pKnowledgeGeneration) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (pKnowledgeGeneration < _knowledgeGeneration)
+        return false;
+    if (pKnowledgeGeneration > _knowledgeGeneration) {
+        _keyToText.clear();
+        _knowledgeGeneration = pKnowledgeGeneration;
+    }
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#ifndef SEMANTIC_ANDROID_SYNTHESISCACHE_HPP
+#define SEMANTIC_ANDROID_SYNTHESISCACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include "lrucache.hpp"
+
+
+/**
+ * Cache of the texts generated from semantic expressions with the knowledge of a semantic memory.
+ * The generation depends on the knowledge of the memory (e.g. the names of the users),
+ * so the cache is emptied when the knowledge generation of the memory changes.
+ * It can be used from several threads, but only while the memory is locked, so that the knowledge
+ * generation cannot change between a generation and its storage in the cache.
+ */
+class SynthesisCache {
+public:
+    explicit SynthesisCache(std::size_t pMaxSize);
+
+    /// The key has to identify the semantic expression and all the parameters of the generation.
+    /// (the expressions are identified by their structural hash, cf semExpStructuralHash)
+    bool get(const std::string &pKey, std::uint64_t pKnowledgeGeneration, std::string &pText);
+    void put(const std::string &pKey, std::uint64_t pKnowledgeGeneration, std::string pText);
+
+private:
+    LruCache<std::string> _keyToText;
+    std::mutex _mutex;
+    std::uint64_t _knowledgeGeneration;
+
+    /// Return false if the knowledge generation is older than the content of the cache.
+    bool _updateKnowledgeGeneration(std::uint64_t pKnowledgeGeneration);
+};
+
+
+#endif // SEMANTIC_ANDROID_SYNTHESISCACHE_HPP
@@ -3,32 +3,36 @@
 #include <onsem/texttosemantic/dbtype/textprocessingcontext.hpp>
 #include "onsem-jni.h"
 #include "jobjectstocpptypes.hpp"
+#include "objectregistry.hpp"
 
 
 using namespace onsem;
 
 namespace {
-    std::map<jint, TextProcessingContext> _idToTextProcessingContext;
+    struct TextProcessingContextWithKey {
+        TextProcessingContext textProcessingContext;
+        /// The parameters of the construction, they identify the context in the caches.
+        std::string key;
+    };
 
-    jint _newTextProcessingContext(TextProcessingContext &&pTextProcessingContext) {
-        int newTPC = findMissingKey(_idToTextProcessingContext);
-        _idToTextProcessingContext.emplace(newTPC, std::move(pTextProcessingContext));
-        return newTPC;
-    }
+    ObjectRegistry<const TextProcessingContextWithKey> _idToTextProcessingContext("text processing context");
 
-    TextProcessingContext &_getTextProcessingContext(int pTextProcessingContextId) {
-        auto it = _idToTextProcessingContext.find(pTextProcessingContextId);
-        if (it == _idToTextProcessingContext.end()) {
-            std::stringstream ssErrorMessage;
-            ssErrorMessage << "wrong text processing context id: " << pTextProcessingContextId;
-            throw std::runtime_error(ssErrorMessage.str());
-        }
-        return it->second;
+    jint _newTextProcessingContext(TextProcessingContext &&pTextProcessingContext, std::string pKey) {
+        return _idToTextProcessingContext.add(std::make_shared<const TextProcessingContextWithKey>(
+                TextProcessingContextWithKey{std::move(pTextProcessingContext), std::move(pKey)}));
     }
 }
 
-TextProcessingContext &getTextProcessingContext(JNIEnv *env, jobject pTextProcessingContext) {
-    return _getTextProcessingContext(toDisposableWithIdId(env, pTextProcessingContext));
+std::shared_ptr<const TextProcessingContext> getTextProcessingContext(JNIEnv *env, jobject pTextProcessingContext) {
+    auto textProcessingContextWithKey = _idToTextProcessingContext.get(
+            toDisposableWithIdId(env, pTextProcessingContext));
+    const auto &textProcessingContext = textProcessingContextWithKey->textProcessingContext;
+    return std::shared_ptr<const TextProcessingContext>(std::move(textProcessingContextWithKey),
+                                                        &textProcessingContext);
+}
+
+std::string getTextProcessingContextKey(JNIEnv *env, jobject pTextProcessingContext) {
+    return _idToTextProcessingContext.get(toDisposableWithIdId(env, pTextProcessingContext))->key;
 }
 
 
@@ -37,7 +41,7 @@ JNIEXPORT jint JNICALL
 Java_com_onsem_TextProcessingContextKt_newTextProcessingContext(
         JNIEnv *env, jclass /*clazz*/, jboolean toRobot, jobject locale,
         jobjectArray resourceLabelArray) {
-    return protectByMutexWithReturn<jint>([&]() {
+    return convertCppExceptionsToJavaExceptionsAndReturnTheResult<jint>(env, [&]() {
         auto language = toLanguage(env, locale);
 
         auto textProcFromRobot = [&]() {
@@ -48,26 +52,27 @@ Java_com_onsem_TextProcessingContextKt_newTextProcessingContext(
         textProcFromRobot.setUsAsEverybody();
         textProcFromRobot.vouvoiement = true;
         std::vector<std::string> resourceLabels;
+        std::string key = std::string(toRobot ? "toRobot " : "fromRobot ") +
+                          semanticLanguageEnum_toLegacyStr(language);
         int size = env->GetArrayLength(resourceLabelArray);
         for (int i = 0; i < size; ++i) {
             auto resourceLabelJStr = reinterpret_cast<jstring>(env->GetObjectArrayElement(
                     resourceLabelArray, i));
             resourceLabels.emplace_back(toString(env, resourceLabelJStr));
             env->DeleteLocalRef(resourceLabelJStr);
+            key += '\n' + resourceLabels.back();
         }
         textProcFromRobot.cmdGrdExtractorPtr =
                 std::make_shared<ResourceGroundingExtractor>(resourceLabels);
-        return _newTextProcessingContext(std::move(textProcFromRobot));
-    });
+        return _newTextProcessingContext(std::move(textProcFromRobot), std::move(key));
+    }, -1);
 }
 
 extern "C"
 JNIEXPORT void JNICALL
 Java_com_onsem_TextProcessingContextKt_deleteTextProcessingContext(
         JNIEnv *env, jclass /*clazz*/, jint textProcessingContextId) {
-    protectByMutex([&]() {
-        _idToTextProcessingContext.erase(textProcessingContextId);
-    });
+    _idToTextProcessingContext.remove(textProcessingContextId);
 }
 
 
@@ -2,13 +2,18 @@
 #define SEMANTIC_ANDROID_TEXTPROCESSINGCONTEXT_JNI_HPP
 
 #include <cstddef>
+#include <memory>
+#include <string>
 #include <jni.h>
 namespace onsem {
     struct TextProcessingContext;
 }
 
 
-onsem::TextProcessingContext &getTextProcessingContext(JNIEnv *env, jobject pTextProcessingContext);
+/// The text processing contexts are never modified after their creation, so the returned pointer is only to keep it alive.
+std::shared_ptr<const onsem::TextProcessingContext> getTextProcessingContext(JNIEnv *env, jobject pTextProcessingContext);
+/// Describe the content of a text processing context, 2 contexts with the same key are equivalent.
+std::string getTextProcessingContextKey(JNIEnv *env, jobject pTextProcessingContext);
 
 
 
@@ -0,0 +1,49 @@
+#include "toprecommendations.hpp"
+#include <algorithm>
+
+
+TopRecommendations::TopRecommendations(std::size_t pMaxSize, int pMinScore)
+        : _maxSize(pMaxSize),
+          _minScore(pMinScore),
+          _heap() {
+    _heap.reserve(pMaxSize);
+}
+
+
+bool TopRecommendations::canKeep(int pScore) const {
+    if (pScore < _minScore || _maxSize == 0)
+        return false;
+    // For the same score as the worst kept recommendation, it depends on the id
+    return _heap.size() < _maxSize || pScore >= _heap.front().score;
+}
+
+
+void TopRecommendations::add(const std::string &pId, int pScore) {
+    if (!canKeep(pScore))
+        return;
+    ScoredRecommendation candidate{pId, pScore};
+    if (_heap.size() < _maxSize) {
+        _heap.emplace_back(std::move(candidate));
+        std::push_heap(_heap.begin(), _heap.end(), _isBetter);
+        return;
+    }
+    if (!_isBetter(candidate, _heap.front()))
+        return;
+    std::pop_heap(_heap.begin(), _heap.end(), _isBetter);
+    _heap.back() = std::move(candidate);
+    std::push_heap(_heap.begin(), _heap.end(), _isBetter);
+}
+
+
+std::vector<ScoredRecommendation> TopRecommendations::takeSorted() {
+    // The comparison puts the best recommendations first
+    std::sort_heap(_heap.begin(), _heap.end(), _isBetter);
+    return std::move(_heap);
+}
+
+
+bool TopRecommendations::_isBetter(const ScoredRecommendation &pA, const ScoredRecommendation &pB) {
+    if (pA.score != pB.score)
+        return pA.score > pB.score;
+    return pA.id < pB.id;
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#ifndef SEMANTIC_ANDROID_TOPRECOMMENDATIONS_HPP
+#define SEMANTIC_ANDROID_TOPRECOMMENDATIONS_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+struct ScoredRecommendation {
+    std::string id;
+    int score;
+};
+
+
+/**
+ * Keep the K recommendations of best score among candidates that come in any order.
+ * The candidates are kept in a min-heap of K elements, so the selection is in O(n log K)
+ * and a candidate that cannot enter the top is rejected in O(1) without being copied.
+ * For the same score, the recommendations are ordered by their id, so the result does not depend
+ * on the order of the candidates.
+ */
+class TopRecommendations {
+public:
+    /// @param pMinScore The candidates below this score are ignored.
+    TopRecommendations(std::size_t pMaxSize, int pMinScore);
+
+    /// True if a candidate of this score would be kept, so the caller can skip the rejected candidates
+    /// without building them. (the candidates are already scored, only their selection is shortened)
+    bool canKeep(int pScore) const;
+    void add(const std::string &pId, int pScore);
+
+    /// The kept recommendations, from the best one to the worst one.
+    std::vector<ScoredRecommendation> takeSorted();
+
+private:
+    const std::size_t _maxSize;
+    const int _minScore;
+    /// Heap whose front is the worst kept recommendation.
+    std::vector<ScoredRecommendation> _heap;
+
+    static bool _isBetter(const ScoredRecommendation &pA, const ScoredRecommendation &pB);
+};
+
+
+#endif // SEMANTIC_ANDROID_TOPRECOMMENDATIONS_HPP
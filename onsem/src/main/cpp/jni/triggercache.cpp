@@ -0,0 +1,121 @@
+#include "triggercache.hpp"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <onsem/texttosemantic/dbtype/semanticexpression/semanticexpression.hpp>
+#include "semanticserialization.hpp"
+
+using namespace onsem;
+
+namespace {
+    constexpr char _magic[8] = {'O', 'N', 'S', 'E', 'M', 'T', 'R', 'C'};
+    constexpr std::uint32_t _formatVersion = 2;
+
+    /// The key starts with the language.
+    std::string _toKey(const std::string &pLanguageStr,
+                       const std::string &pText,
+                       const std::string &pContextName) {
+        return pLanguageStr + '\n' + pContextName + '\n' + pText;
+    }
+
+    std::string _languageStrOfKey(const std::string &pKey) {
+        return pKey.substr(0, pKey.find('\n'));
+    }
+}
+
+
+TriggerCache::TriggerCache(std::string pFilename,
+                           std::string pLibraryVersion,
+                           std::function<std::string(SemanticLanguageEnum)> pDatabaseVersion)
+        : _filename(std::move(pFilename)),
+          _libraryVersion(std::move(pLibraryVersion)),
+          _databaseVersion(std::move(pDatabaseVersion)),
+          _mutex(),
+          _keyToExpression(),
+          _languageToDatabaseVersion(),
+          _isModified(false) {
+    std::ifstream in(_filename, std::ios::binary);
+    if (!in)
+        return;
+    try {
+        char magic[sizeof(_magic)];
+        if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, _magic, sizeof(_magic)) != 0 ||
+            binaryfile::readUint32(in) != _formatVersion ||
+            binaryfile::readString(in) != _libraryVersion)
+            return; // The file will be replaced at the next save
+        auto nbOfExpressions = binaryfile::readUint32(in);
+        for (std::uint32_t i = 0; i < nbOfExpressions; ++i) {
+            auto key = binaryfile::readString(in);
+            CachedExpression expression;
+            expression.databaseVersion = binaryfile::readString(in);
+            expression.serializedSemExp = binaryfile::readString(in);
+            _keyToExpression.emplace(std::move(key), std::move(expression));
+        }
+    } catch (const std::exception &e) {
+        std::cout << "the trigger cache " << _filename << " is ignored: " << e.what() << std::endl;
+        _keyToExpression.clear();
+    }
+}
+
+
+UniqueSemanticExpression TriggerCache::getOrParse(
+        const std::string &pText,
+        SemanticLanguageEnum pLanguage,
+        const std::string &pContextName,
+        const std::function<UniqueSemanticExpression()> &pParse) {
+    // The version is computed only once per language, by the linguistic database
+    auto databaseVersion = _databaseVersion(pLanguage);
+    if (databaseVersion.empty())
+        return pParse();
+    auto languageStr = semanticLanguageEnum_toLegacyStr(pLanguage);
+    auto key = _toKey(languageStr, pText, pContextName);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _languageToDatabaseVersion[languageStr] = databaseVersion;
+        auto it = _keyToExpression.find(key);
+        if (it != _keyToExpression.end() && it->second.databaseVersion == databaseVersion) {
+            try {
+                return stringToSemExp(it->second.serializedSemExp);
+            } catch (const std::exception &) {
+                // A corrupted entry is parsed again
+                _keyToExpression.erase(it);
+            }
+        }
+    }
+
+    // The parsing is done without the lock, so that the triggers can be parsed in parallel
+    auto res = pParse();
+    CachedExpression expression{std::move(databaseVersion), semExpToString(*res)};
+    std::lock_guard<std::mutex> lock(_mutex);
+    _keyToExpression[key] = std::move(expression);
+    _isModified = true;
+    return res;
+}
+
+
+void TriggerCache::save() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_isModified)
+        return;
+    // The expressions parsed with a previous version of the databases of a language are removed
+    // (the languages not used since the loading keep their expressions)
+    for (auto it = _keyToExpression.begin(); it != _keyToExpression.end();) {
+        auto itVersion = _languageToDatabaseVersion.find(_languageStrOfKey(it->first));
+        if (itVersion != _languageToDatabaseVersion.end() && itVersion->second != it->second.databaseVersion)
+            it = _keyToExpression.erase(it);
+        else
+            ++it;
+    }
+    binaryfile::writeFileAtomically(_filename, [this](std::ostream &pOut) {
+        pOut.write(_magic, sizeof(_magic));
+        binaryfile::writeUint32(pOut, _formatVersion);
+        binaryfile::writeString(pOut, _libraryVersion);
+        binaryfile::writeUint32(pOut, static_cast<std::uint32_t>(_keyToExpression.size()));
+        for (const auto &currExpression : _keyToExpression) {
+            binaryfile::writeString(pOut, currExpression.first);
+            binaryfile::writeString(pOut, currExpression.second.databaseVersion);
+            binaryfile::writeString(pOut, currExpression.second.serializedSemExp);
+        }
+    });
+    _isModified = false;
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#ifndef SEMANTIC_ANDROID_TRIGGERCACHE_HPP
+#define SEMANTIC_ANDROID_TRIGGERCACHE_HPP
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <onsem/common/enum/semanticlanguageenum.hpp>
+
+namespace onsem {
+    struct UniqueSemanticExpression;
+}
+
+
+/**
+ * Cache of the parsed texts of the triggers, stored in a file so that the triggers are not parsed
+ * again at the next start.
+ * The key of an expression is its text, its language and the name of the context of the parsing.
+ * Each expression stores the version of the linguistic databases of its language (a hash of their content),
+ * it is parsed again if this version changes.
+ * The file stores the version of the library, it is ignored if this version changes.
+ * It can be used from several threads.
+ */
+class TriggerCache {
+public:
+    /**
+     * @param pLibraryVersion Version of the library that serializes the expressions.
+     * @param pDatabaseVersion Get the version of the linguistic databases used to parse a language,
+     * an empty version disables the cache.
+     */
+    TriggerCache(std::string pFilename,
+                 std::string pLibraryVersion,
+                 std::function<std::string(onsem::SemanticLanguageEnum)> pDatabaseVersion);
+
+    /// Get the expression from the cache, or parse it and add it to the cache.
+    onsem::UniqueSemanticExpression getOrParse(
+            const std::string &pText,
+            onsem::SemanticLanguageEnum pLanguage,
+            const std::string &pContextName,
+            const std::function<onsem::UniqueSemanticExpression()> &pParse);
+
+    /// Write the file, if something was added since the loading.
+    void save();
+
+private:
+    struct CachedExpression {
+        std::string databaseVersion;
+        std::string serializedSemExp;
+    };
+
+    const std::string _filename;
+    const std::string _libraryVersion;
+    const std::function<std::string(onsem::SemanticLanguageEnum)> _databaseVersion;
+    std::mutex _mutex;
+    std::unordered_map<std::string, CachedExpression> _keyToExpression;
+    /// The versions already computed, the expressions of the other versions are not saved.
+    std::unordered_map<std::string, std::string> _languageToDatabaseVersion;
+    bool _isModified;
+};
+
+
+#endif // SEMANTIC_ANDROID_TRIGGERCACHE_HPP
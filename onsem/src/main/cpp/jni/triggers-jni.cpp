@@ -1,6 +1,8 @@
 #include <jni.h>
 #include <memory>
 #include <mutex>
+#include <string>
+#include <vector>
 #include "jobjectstocpptypes.hpp"
 #include "semanticenumsindexes.hpp"
 #include "androidlog.hpp"
@@ -9,6 +11,9 @@
 #include "semanticmemory-jni.hpp"
 #include "semanticexpression-jni.hpp"
 #include "onsem-jni.h"
+#include "paralleltasks.hpp"
+#include "triggercache.hpp"
+#include "memoryjournal.hpp"
 #include "onsem/texttosemantic/languagedetector.hpp"
 #include <onsem/texttosemantic/tool/semexpgetter.hpp>
 #include <onsem/texttosemantic/dbtype/semanticexpression/groundedexpression.hpp>
@@ -21,36 +26,61 @@
 using namespace onsem;
 
 namespace {
-    UniqueSemanticExpression _createResourceSemExp(JNIEnv *env,
-                                                   jstring resourceTypeJStr,
-                                                   jstring resourceIdJStr,
-                                                   jobject parametersJObj,
+    /// Parse a text of a trigger, or get it from the trigger cache of the linguistic database if it has one.
+    UniqueSemanticExpression _textToContextualSemExp(const std::shared_ptr<TriggerCache> &pTriggerCache,
+                                                     const std::string &pText,
+                                                     const TextProcessingContext &pTextProcContext,
+                                                     SemanticLanguageEnum pLanguage,
+                                                     const std::string &pContextName,
+                                                     const linguistics::LinguisticDatabase &pLingDb) {
+        auto parse = [&]() {
+            return converter::textToContextualSemExp(pText, pTextProcContext,
+                                                     SemanticSourceEnum::UNKNOWN, pLingDb);
+        };
+        if (!pTriggerCache)
+            return parse();
+        return pTriggerCache->getOrParse(pText, pLanguage, pContextName, parse);
+    }
+
+
+    void _addTrigger(const WriteLockedSemanticMemory &pLockedSemanticMemory,
+                     UniqueSemanticExpression pTriggerSemExp,
+                     UniqueSemanticExpression pAnswerSemExp,
+                     const linguistics::LinguisticDatabase &pLingDb) {
+        auto *journal = pLockedSemanticMemory.journal();
+        if (journal == nullptr) {
+            triggers::add(std::move(pTriggerSemExp), std::move(pAnswerSemExp), *pLockedSemanticMemory, pLingDb);
+            return;
+        }
+        // Only the operations that succeeded are journaled
+        triggers::add(pTriggerSemExp->clone(), pAnswerSemExp->clone(), *pLockedSemanticMemory, pLingDb);
+        journal->addTrigger(std::move(pTriggerSemExp), std::move(pAnswerSemExp));
+    }
+
+    UniqueSemanticExpression _createResourceSemExp(const std::shared_ptr<TriggerCache> &pTriggerCache,
+                                                   const std::string &pResourceType,
+                                                   const std::string &pResourceId,
+                                                   const std::map<std::string, std::vector<std::string>> &pParameters,
                                                    SemanticLanguageEnum pLanguage,
                                                    const UniqueSemanticExpression& pTriggerSemExp,
                                                    const linguistics::LinguisticDatabase &pLingDb) {
-        auto resourceTypeStr = toString(env, resourceTypeJStr);
-        auto resourceIdStr = toString(env, resourceIdJStr);
-
-        std::map<std::string, std::vector<std::string>> parameters;
-        JavaHashMapToStlStringStringVectorMap(env, parametersJObj, parameters);
-
         TextProcessingContext paramQuestionProcContext(SemanticAgentGrounding::me,
                                                        SemanticAgentGrounding::currentUser,
                                                        pLanguage);
         paramQuestionProcContext.isTimeDependent = false;
-        auto answerGrd = std::make_unique<SemanticResourceGrounding>(resourceTypeStr, pLanguage,
-                                                                     resourceIdStr);
+        auto answerGrd = std::make_unique<SemanticResourceGrounding>(pResourceType, pLanguage,
+                                                                     pResourceId);
 
-        for (auto &currParameter: parameters) {
+        for (auto &currParameter: pParameters) {
             for (auto &currQuestion: currParameter.second) {
                 SemanticMemory semMemory;
                 memoryOperation::inform(
                         std::make_unique<MetadataExpression>
                                 (SemanticSourceEnum::WRITTENTEXT, UniqueSemanticExpression(), pTriggerSemExp->clone()),
                         semMemory, pLingDb);
-                auto paramSemExp = converter::textToContextualSemExp(currQuestion,
-                                                                     paramQuestionProcContext,
-                                                                     SemanticSourceEnum::UNKNOWN, pLingDb);
+                // Only the parsing is cached, the merge depends on the trigger
+                auto paramSemExp = _textToContextualSemExp(pTriggerCache, currQuestion, paramQuestionProcContext,
+                                                           pLanguage, "parameterQuestion", pLingDb);
                 memoryOperation::mergeWithContext(paramSemExp, semMemory, pLingDb);
                 answerGrd->resource.parameterLabelsToQuestions[currParameter.first].emplace_back(std::move(paramSemExp));
             }
@@ -71,30 +101,25 @@ Java_com_onsem_TriggersKt_addTrigger(
         jobject semanticMemoryJObj,
         jobject linguisticDatabaseJObj) {
     convertCppExceptionsToJavaExceptions(env, [&]() {
-        protectByMutex([&] {
-            auto language = toLanguage(env, locale);
-            auto &lingDb = getLingDb(env, linguisticDatabaseJObj);
-            auto &semanticMemory = getSemanticMemory(env, semanticMemoryJObj);
-            {
-                auto triggerStr = toString(env, triggerJStr);
-                auto textProcessingContextToRobot = TextProcessingContext::getTextProcessingContextToRobot(
-                        language);
-                auto triggerSemExp = converter::textToContextualSemExp(triggerStr,
-                                                                       textProcessingContextToRobot,
-                                                                       SemanticSourceEnum::UNKNOWN,
-                                                                       lingDb);
-
-                auto answerStr = toString(env, answerJStr);
-                auto textProcessingContextFromRobot = TextProcessingContext::getTextProcessingContextFromRobot(
-                        language);
-                auto answerSemExp = converter::textToContextualSemExp(answerStr,
-                                                                      textProcessingContextFromRobot,
-                                                                      SemanticSourceEnum::UNKNOWN,
-                                                                      lingDb);
-
-                triggers::add(std::move(triggerSemExp), std::move(answerSemExp), semanticMemory, lingDb);
-            }
-        });
+        auto language = toLanguage(env, locale);
+        auto lingDbPtr = getLingDb(env, linguisticDatabaseJObj, language);
+        auto &lingDb = *lingDbPtr;
+        auto triggerCache = getTriggerCache(env, linguisticDatabaseJObj);
+        auto triggerStr = toString(env, triggerJStr);
+        auto textProcessingContextToRobot = TextProcessingContext::getTextProcessingContextToRobot(
+                language);
+        auto triggerSemExp = _textToContextualSemExp(triggerCache, triggerStr, textProcessingContextToRobot,
+                                                     language, "toRobot", lingDb);
+
+        auto answerStr = toString(env, answerJStr);
+        auto textProcessingContextFromRobot = TextProcessingContext::getTextProcessingContextFromRobot(
+                language);
+        auto answerSemExp = _textToContextualSemExp(triggerCache, answerStr, textProcessingContextFromRobot,
+                                                    language, "fromRobot", lingDb);
+
+        // The triggers do not change how the expressions are said, so the synthesis cache stays valid
+        auto semanticMemory = writeSemanticMemory(env, semanticMemoryJObj, false);
+        _addTrigger(semanticMemory, std::move(triggerSemExp), std::move(answerSemExp), lingDb);
     });
 }
 
@@ -111,24 +136,97 @@ Java_com_onsem_TriggersKt_addTriggerToAResource(
         jobject semanticMemoryJObj,
         jobject linguisticDatabaseJObj) {
     convertCppExceptionsToJavaExceptions(env, [&]() {
-        protectByMutex([&] {
-            auto language = toLanguage(env, locale);
-            auto &lingDb = getLingDb(env, linguisticDatabaseJObj);
-            auto &semanticMemory = getSemanticMemory(env, semanticMemoryJObj);
-            {
-                auto triggerStr = toString(env, triggerJStr);
-                auto textProcessingContextToRobot = TextProcessingContext::getTextProcessingContextToRobot(
-                        language);
-                auto triggerSemExp = converter::textToContextualSemExp(triggerStr,
-                                                                       textProcessingContextToRobot,
-                                                                       SemanticSourceEnum::UNKNOWN,
-                                                                       lingDb);
-                auto resourceSemExp = _createResourceSemExp(env, resourceTypeJStr, resourceIdJStr, parametersJObj, language, triggerSemExp, lingDb);
-
-                triggers::add(std::move(triggerSemExp), std::move(resourceSemExp),
-                              semanticMemory, lingDb);
-            }
+        auto language = toLanguage(env, locale);
+        auto lingDbPtr = getLingDb(env, linguisticDatabaseJObj, language);
+        auto &lingDb = *lingDbPtr;
+        auto triggerStr = toString(env, triggerJStr);
+        auto textProcessingContextToRobot = TextProcessingContext::getTextProcessingContextToRobot(
+                language);
+        auto triggerCache = getTriggerCache(env, linguisticDatabaseJObj);
+        auto triggerSemExp = _textToContextualSemExp(triggerCache, triggerStr,
+                                                     textProcessingContextToRobot, language, "toRobot", lingDb);
+        std::map<std::string, std::vector<std::string>> parameters;
+        JavaHashMapToStlStringStringVectorMap(env, parametersJObj, parameters);
+        auto resourceSemExp = _createResourceSemExp(triggerCache, toString(env, resourceTypeJStr),
+                                                    toString(env, resourceIdJStr), parameters, language,
+                                                    triggerSemExp, lingDb);
+
+        // The triggers do not change how the expressions are said, so the synthesis cache stays valid
+        auto semanticMemory = writeSemanticMemory(env, semanticMemoryJObj, false);
+        _addTrigger(semanticMemory, std::move(triggerSemExp), std::move(resourceSemExp), lingDb);
+    });
+}
+
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_onsem_TriggersKt_addTriggersCpp(
+        JNIEnv *env, jclass /*clazz*/,
+        jobjectArray triggersJArray,
+        jobjectArray answersJArray,
+        jobjectArray resourceTypesJArray,
+        jobjectArray resourceIdsJArray,
+        jobjectArray parametersJArray,
+        jobject locale,
+        jobject semanticMemoryJObj,
+        jobject linguisticDatabaseJObj) {
+    convertCppExceptionsToJavaExceptions(env, [&]() {
+        auto language = toLanguage(env, locale);
+        auto lingDbPtr = getLingDb(env, linguisticDatabaseJObj, language);
+        auto &lingDb = *lingDbPtr;
+
+        struct TriggerToAdd {
+            std::string trigger;
+            std::string answer;
+            std::string resourceType;
+            std::string resourceId;
+            std::map<std::string, std::vector<std::string>> parameters;
+            UniqueSemanticExpression triggerSemExp;
+            UniqueSemanticExpression answerSemExp;
+        };
+        auto triggerStrs = javaArrayToStlStringVector(env, triggersJArray);
+        auto answerStrs = javaArrayToStlStringVector(env, answersJArray);
+        auto resourceTypeStrs = javaArrayToStlStringVector(env, resourceTypesJArray);
+        auto resourceIdStrs = javaArrayToStlStringVector(env, resourceIdsJArray);
+        std::vector<TriggerToAdd> triggersToAdd(triggerStrs.size());
+        for (std::size_t i = 0; i < triggersToAdd.size(); ++i) {
+            auto &triggerToAdd = triggersToAdd[i];
+            triggerToAdd.trigger = std::move(triggerStrs[i]);
+            triggerToAdd.answer = std::move(answerStrs[i]);
+            triggerToAdd.resourceType = std::move(resourceTypeStrs[i]);
+            triggerToAdd.resourceId = std::move(resourceIdStrs[i]);
+            auto parametersJObj = env->GetObjectArrayElement(parametersJArray, static_cast<jsize>(i));
+            JavaHashMapToStlStringStringVectorMap(env, parametersJObj, triggerToAdd.parameters);
+            env->DeleteLocalRef(parametersJObj);
+        }
+
+        // The texts are parsed in parallel, without the lock of the semantic memory
+        auto triggerCache = getTriggerCache(env, linguisticDatabaseJObj);
+        auto textProcessingContextToRobot = TextProcessingContext::getTextProcessingContextToRobot(
+                language);
+        auto textProcessingContextFromRobot = TextProcessingContext::getTextProcessingContextFromRobot(
+                language);
+        runInParallel(triggersToAdd.size(), getNbOfWorkerThreads(), [&](std::size_t pTriggerIndex) {
+            auto &triggerToAdd = triggersToAdd[pTriggerIndex];
+            triggerToAdd.triggerSemExp = _textToContextualSemExp(triggerCache, triggerToAdd.trigger,
+                                                                 textProcessingContextToRobot,
+                                                                 language, "toRobot", lingDb);
+            if (triggerToAdd.resourceType.empty())
+                triggerToAdd.answerSemExp = _textToContextualSemExp(triggerCache, triggerToAdd.answer,
+                                                                    textProcessingContextFromRobot,
+                                                                    language, "fromRobot", lingDb);
+            else
+                triggerToAdd.answerSemExp = _createResourceSemExp(triggerCache, triggerToAdd.resourceType,
+                                                                  triggerToAdd.resourceId, triggerToAdd.parameters,
+                                                                  language, triggerToAdd.triggerSemExp, lingDb);
         });
+
+        // Then they are added in the order of the array, with only one lock of the semantic memory
+        // (the triggers do not change how the expressions are said, so the synthesis cache stays valid)
+        auto semanticMemory = writeSemanticMemory(env, semanticMemoryJObj, false);
+        for (auto &currTriggerToAdd : triggersToAdd)
+            _addTrigger(semanticMemory, std::move(currTriggerToAdd.triggerSemExp),
+                        std::move(currTriggerToAdd.answerSemExp), lingDb);
     });
 }
 
@@ -145,13 +243,15 @@ Java_com_onsem_TriggersKt_addPlannerActionToMemory(
         jobject semanticMemoryJObj,
         jobject linguisticDatabaseJObj) {
 
-    auto triggerStr = toString(env, triggerJStr);
+    convertCppExceptionsToJavaExceptions(env, [&]() {
+        auto triggerStr = toString(env, triggerJStr);
+        if (triggerStr.empty())
+            return;
 
-    auto language = toLanguage(env, locale);
-    auto &semanticMemory = getSemanticMemory(env, semanticMemoryJObj);
-    auto &lingDb = getLingDb(env, linguisticDatabaseJObj);
+        auto language = toLanguage(env, locale);
+        auto lingDbPtr = getLingDb(env, linguisticDatabaseJObj, language);
+        auto &lingDb = *lingDbPtr;
 
-    if (!triggerStr.empty()) {
         SemanticLanguageEnum textLanguage = language == SemanticLanguageEnum::UNKNOWN ?
                                             linguistics::getLanguage(triggerStr, lingDb) : language;
 
@@ -160,7 +260,10 @@ Java_com_onsem_TriggersKt_addPlannerActionToMemory(
                                                  textLanguage);
         triggerProcContext.setUsAsEverybody();
         triggerProcContext.isTimeDependent = false;
-        auto actionSemExp = converter::textToSemExp(triggerStr, triggerProcContext, lingDb);
+        auto parseAction = [&]() { return converter::textToSemExp(triggerStr, triggerProcContext, lingDb); };
+        auto triggerCache = getTriggerCache(env, linguisticDatabaseJObj);
+        auto actionSemExp = triggerCache ?
+                triggerCache->getOrParse(triggerStr, textLanguage, "plannerAction", parseAction) : parseAction();
 
 
         auto itIsAnActionIdStr = toString(env, itIsAnActionIdJStr);
@@ -173,6 +276,8 @@ Java_com_onsem_TriggersKt_addPlannerActionToMemory(
                         converter::createResourceWithParameters(itIsAnActionIdStr, actionIdStr, parameters,
                                                                 *actionSemExp, lingDb, textLanguage));
 
+        auto lockedSemanticMemory = writeSemanticMemory(env, semanticMemoryJObj);
+        auto &semanticMemory = *lockedSemanticMemory;
         if (textLanguage == SemanticLanguageEnum::UNKNOWN)
             textLanguage = semanticMemory.defaultLanguage;
         mystd::unique_propagate_const<UniqueSemanticExpression> reaction;
@@ -182,15 +287,15 @@ Java_com_onsem_TriggersKt_addPlannerActionToMemory(
             auto inputSemExpInMemory = memoryOperation::teachSplitted(reaction, semanticMemory,
                                                                       (*infinitiveActionSemExp)->clone(), outputResourceGrdExp->clone(),
                                                                       lingDb, memoryOperation::SemanticActionOperatorEnum::BEHAVIOR);
+            if (auto *journal = lockedSemanticMemory.journal())
+                journal->addBehavior((*infinitiveActionSemExp)->clone(), outputResourceGrdExp->clone());
 
-            triggers::add(std::move(*infinitiveActionSemExp), outputResourceGrdExp->clone(),
-                          semanticMemory, lingDb);
+            _addTrigger(lockedSemanticMemory, std::move(*infinitiveActionSemExp), outputResourceGrdExp->clone(),
+                        lingDb);
         }
 
-        triggers::add(std::move(actionSemExp),
-                      std::move(outputResourceGrdExp),
-                      semanticMemory, lingDb);
-    }
+        _addTrigger(lockedSemanticMemory, std::move(actionSemExp), std::move(outputResourceGrdExp), lingDb);
+    });
 }
 
 
@@ -204,23 +309,25 @@ Java_com_onsem_TriggersKt_reactFromTriggerCpp(
         jobject linguisticDatabaseJObj,
         jobject jExecutor) {
     return convertCppExceptionsToJavaExceptionsAndReturnTheResult<jstring>(env, [&]() {
-        return protectByMutexWithReturn<jstring>([&] {
-            auto &lingDb = getLingDb(env, linguisticDatabaseJObj);
-            auto &semanticMemory = getSemanticMemory(env, semanticMemoryJObj);
-            auto &semExp = getSemExp(env, semanticExpressionJObj);
-
-            mystd::unique_propagate_const<UniqueSemanticExpression> reaction;
-            triggers::match(
-                    reaction, semanticMemory, semExp->clone(),
-                    lingDb);
-
-            if (!reaction)
-                return env->NewStringUTF("");
-            auto reactionType = SemExpGetter::extractContextualAnnotation(**reaction);
-            auto language = toLanguage(env, locale);
-            runOutputter(env, language, semanticMemory, lingDb, **reaction, jExecutor,
-                         false, &*semExp);
-            return env->NewStringUTF(contextualAnnotation_toStr(reactionType).c_str());
-        });
+        auto language = toLanguage(env, locale);
+        auto lingDbPtr = getLingDb(env, linguisticDatabaseJObj, language);
+        auto &lingDb = *lingDbPtr;
+        auto semExpPtr = getSemExp(env, semanticExpressionJObj);
+        auto &semExp = *semExpPtr;
+        // The matching of the triggers does not change the knowledge, so the canned answers stay in the synthesis cache
+        auto lockedSemanticMemory = writeSemanticMemory(env, semanticMemoryJObj, false);
+        auto &semanticMemory = *lockedSemanticMemory;
+
+        mystd::unique_propagate_const<UniqueSemanticExpression> reaction;
+        triggers::match(
+                reaction, semanticMemory, semExp->clone(),
+                lingDb);
+
+        if (!reaction)
+            return env->NewStringUTF("");
+        auto reactionType = SemExpGetter::extractContextualAnnotation(**reaction);
+        runOutputter(env, language, lockedSemanticMemory, lingDb, **reaction, jExecutor,
+                     false, &*semExp);
+        return env->NewStringUTF(contextualAnnotation_toStr(reactionType).c_str());
     }, nullptr);
 }
@@ -0,0 +1,120 @@
+#include "workerpool.hpp"
+#include <iostream>
+#include "javabindings.hpp"
+#include "paralleltasks.hpp"
+
+
+WorkerPool::WorkerPool(JavaVM *pJavaVM, std::size_t pNbOfThreads)
+        : _javaVM(pJavaVM),
+          _mutex(),
+          _keyReady(),
+          _stopped(false),
+          _keyToJobs(),
+          _readyKeys(),
+          _threads() {
+    for (std::size_t i = 0; i < pNbOfThreads; ++i)
+        _threads.emplace_back([this]() { _run(); });
+}
+
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopped = true;
+    }
+    _keyReady.notify_all();
+    for (auto &currThread : _threads)
+        currThread.join();
+}
+
+
+void WorkerPool::submit(jint pKey, Job pJob, FailureHandler pOnFailure) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto &jobs = _keyToJobs[pKey];
+        jobs.push_back(JobWithFailureHandler{std::move(pJob), std::move(pOnFailure)});
+        // Otherwise a job of this key is already queued or running
+        if (jobs.size() > 1)
+            return;
+        _readyKeys.push_back(pKey);
+    }
+    _keyReady.notify_one();
+}
+
+
+void WorkerPool::_run() {
+    JNIEnv *env = nullptr;
+    JavaVMAttachArgs attachArgs{JNI_VERSION_1_6, "onsem-worker", nullptr};
+    if (_javaVM->AttachCurrentThreadAsDaemon(&env, &attachArgs) != JNI_OK) {
+        // The jobs are run by the other threads of the pool
+        std::cout << "onsem worker cannot be attached to the java VM" << std::endl;
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        _keyReady.wait(lock, [this]() { return _stopped || !_readyKeys.empty(); });
+        if (_stopped)
+            break;
+        auto key = _readyKeys.front();
+        _readyKeys.pop_front();
+        // The job stays in the queue while it runs, so that the next jobs of this key wait for it
+        auto job = std::move(_keyToJobs[key].front());
+        lock.unlock();
+        // This thread never returns to java, so the local references have to be freed after each job
+        if (env->PushLocalFrame(16) == JNI_OK) {
+            try {
+                job.job(env);
+            } catch (const std::exception &e) {
+                std::cout << "onsem worker job failed: " << e.what() << std::endl;
+                env->ThrowNew(getJavaBindings().runtimeExceptionClass, e.what());
+                _failWithThePendingException(env, job.onFailure);
+            }
+            if (env->ExceptionCheck()) {
+                std::cout << "onsem worker job left a java exception" << std::endl;
+                env->ExceptionClear();
+            }
+            env->PopLocalFrame(nullptr);
+        } else {
+            // The frame could not be allocated, so an OutOfMemoryError is pending
+            std::cout << "onsem worker cannot allocate the local references of a job" << std::endl;
+            _failWithThePendingException(env, job.onFailure);
+        }
+        job = JobWithFailureHandler();
+        lock.lock();
+
+        auto itJobs = _keyToJobs.find(key);
+        itJobs->second.pop_front();
+        if (itJobs->second.empty()) {
+            _keyToJobs.erase(itJobs);
+        } else {
+            _readyKeys.push_back(key);
+            _keyReady.notify_one();
+        }
+    }
+    lock.unlock();
+    _javaVM->DetachCurrentThread();
+}
+
+
+void WorkerPool::_failWithThePendingException(JNIEnv *env, const FailureHandler &pOnFailure) {
+    jthrowable error = env->ExceptionOccurred();
+    env->ExceptionClear();
+    if (error == nullptr)
+        return;
+    pOnFailure(env, error);
+    if (env->ExceptionCheck())
+        env->ExceptionClear();
+    env->DeleteLocalRef(error);
+}
+
+
+WorkerPool &getWorkerPool(JNIEnv *env) {
+    // Never deleted, because the threads cannot be joined safely while the process exits
+    static WorkerPool *workerPool = [env]() {
+        JavaVM *javaVM = nullptr;
+        env->GetJavaVM(&javaVM);
+        return new WorkerPool(javaVM, getNbOfWorkerThreads());
+    }();
+    return *workerPool;
+}
\ No newline at end of file
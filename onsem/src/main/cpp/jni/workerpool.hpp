@@ -0,0 +1,60 @@
+#ifndef SEMANTIC_ANDROID_WORKERPOOL_HPP
+#define SEMANTIC_ANDROID_WORKERPOOL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <jni.h>
+
+
+/**
+ * Fixed pool of threads that are attached to the java VM for all their life.
+ * The jobs that have the same key (e.g. the id of the semantic memory they modify) are run
+ * one at a time and in the order of their submission.
+ * The jobs that have different keys are run in parallel.
+ * A job that cannot be run, or that throws a C++ exception, is given to its failure handler with a java
+ * exception, so that the java code waiting for the job is always notified.
+ */
+class WorkerPool {
+public:
+    using Job = std::function<void(JNIEnv *)>;
+    using FailureHandler = std::function<void(JNIEnv *, jthrowable)>;
+
+    WorkerPool(JavaVM *pJavaVM, std::size_t pNbOfThreads);
+    ~WorkerPool();
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    void submit(jint pKey, Job pJob, FailureHandler pOnFailure);
+
+private:
+    struct JobWithFailureHandler {
+        Job job;
+        FailureHandler onFailure;
+    };
+
+    JavaVM *_javaVM;
+    std::mutex _mutex;
+    std::condition_variable _keyReady;
+    bool _stopped;
+    /// The jobs of a key, the first one is the running one if the key is not in _readyKeys.
+    std::map<jint, std::deque<JobWithFailureHandler>> _keyToJobs;
+    std::deque<jint> _readyKeys;
+    std::vector<std::thread> _threads;
+
+    void _run();
+    /// Give the pending java exception to the failure handler of a job.
+    static void _failWithThePendingException(JNIEnv *env, const FailureHandler &pOnFailure);
+};
+
+
+/// The pool of the asynchronous operations, it is created at the first call.
+WorkerPool &getWorkerPool(JNIEnv *env);
+
+
+#endif // SEMANTIC_ANDROID_WORKERPOOL_HPP
@@ -1,6 +1,8 @@
 package com.onsem
 
 import android.util.Log
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
 
 
 class JiniOutputter {
@@ -42,6 +44,39 @@ class JiniOutputter {
         getLasExecInStack().numberOfTimes = numberOfTimes;
     }
 
+    /**
+     * Replay the execution events encoded by the native outputter. (cf JiniOutputter in onsem-jni.cpp)
+     * The buffer is only valid during this call.
+     */
+    fun decodeExecutionEvents(events: ByteBuffer) {
+        events.order(ByteOrder.nativeOrder())
+        fun readString(): String {
+            val bytes = ByteArray(events.int)
+            events.get(bytes)
+            return String(bytes, Charsets.UTF_8)
+        }
+        while (events.hasRemaining()) {
+            when (events.get().toInt()) {
+                0 -> exposeText(readString())
+                1 -> {
+                    val label = readString()
+                    val value = readString()
+                    val parameters = HashMap<String, Array<String>>()
+                    repeat(events.int) {
+                        val key = readString()
+                        parameters[key] = Array(events.int) { readString() }
+                    }
+                    exposeResource(label, value, parameters)
+                }
+                2 -> beginOfScope(Link.values()[events.get().toInt()].name)
+                3 -> endOfScope()
+                4 -> resourceNbOfTimes(events.int)
+                5 -> insideScopeNbOfTimes(events.int)
+                else -> throw IllegalStateException("Unknown execution event")
+            }
+        }
+    }
+
     private fun getOrCreateNewElt(): ExecutionData {
         val newElt = getLasExecInStack()
         if (newElt.hasData() || newElt.hasChildren())
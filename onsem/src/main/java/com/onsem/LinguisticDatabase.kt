@@ -1,23 +1,58 @@
 package com.onsem
 
 import android.content.res.AssetManager
+import java.io.File
 import java.util.*
 
 
 /**
  * Linguistic database necessary for the linguistic processing.
- * @param assetManager Assert manager to access to files stored in the assets.
+ * The linguistic databases constructed with the same parameters share the same native database,
+ * which is freed when the last of them is disposed. (but each of them has its own caches)
  */
-class LinguisticDatabase(
-    assetManager: AssetManager,
-    linguisticDatabasesRootFolder: String = "linguistic"
-) : DisposableWithId(
-    newLinguisticDatabase(
-        assetManager,
-        arrayOf(Locale.ENGLISH, Locale.FRENCH, Locale.JAPANESE),
-        linguisticDatabasesRootFolder
+class LinguisticDatabase private constructor(id: Int) : DisposableWithId(id) {
+
+    /**
+     * @param assetManager Assert manager to access to files stored in the assets.
+     * @param useMemoryMappedAssets Read the databases directly from the memory of the assets instead of
+     * reading them chunk by chunk. (it is faster when the databases are not compressed in the apk)
+     * @param locales Languages to load at the construction.
+     * @param loadLanguagesOnDemand Load the other languages at their first use.
+     * (set locales to an empty array to load every language only when it is used)
+     * Loading a language constructs again the whole native database with the languages already loaded,
+     * and the previous database stays in memory until the end of the construction.
+     * So the lazy loading makes the start faster, but each new language costs a full construction and
+     * a peak of memory: preload together the languages that are known to be needed. (cf preloadLanguages)
+     */
+    constructor(
+        assetManager: AssetManager,
+        linguisticDatabasesRootFolder: String = "linguistic",
+        useMemoryMappedAssets: Boolean = true,
+        locales: Array<Locale> = defaultLocales(),
+        loadLanguagesOnDemand: Boolean = false
+    ) : this(
+        newLinguisticDatabase(
+            assetManager,
+            locales,
+            linguisticDatabasesRootFolder,
+            useMemoryMappedAssets,
+            loadLanguagesOnDemand
+        )
+    )
+
+    /**
+     * @param linguisticDatabasesFolder Folder of the file system that contains the databases.
+     * The files are mapped in memory.
+     * @param locales Languages to load at the construction.
+     * @param loadLanguagesOnDemand Load the other languages at their first use. (same cost as above)
+     */
+    constructor(
+        linguisticDatabasesFolder: File,
+        locales: Array<Locale> = defaultLocales(),
+        loadLanguagesOnDemand: Boolean = false
+    ) : this(
+        newLinguisticDatabaseFromFiles(locales, linguisticDatabasesFolder.absolutePath, loadLanguagesOnDemand)
     )
-) {
 
     companion object {
         init {
@@ -25,20 +60,82 @@ class LinguisticDatabase(
         }
     }
 
+    /**
+     * Load a language now instead of at its first use.
+     */
+    fun preloadLanguage(locale: Locale) = preloadLanguages(locale)
+
+    /**
+     * Load several languages now instead of at their first use.
+     * They are loaded with only one construction of the native database, instead of one per language.
+     */
+    fun preloadLanguages(vararg locales: Locale) = preloadLanguagesCpp(id, arrayOf(*locales))
+
+    /**
+     * Store the parsed triggers, and the questions of their parameters, in a file so that they are not
+     * parsed again at the next start.
+     * The file is loaded now, and it is ignored if it was written by another version of the library.
+     * A parsed text is also ignored if the databases of its language changed: the first use of the cache
+     * for a language reads its databases to compute a hash of their content.
+     * The cache is only used through this object, not through the other objects that share its native database.
+     */
+    fun useTriggerCache(cacheFile: File) =
+        useTriggerCacheCpp(id, cacheFile.absolutePath, BuildConfig.ONSEM_VERSION_NAME)
+
+    /**
+     * Write the triggers parsed since the loading of the trigger cache in its file.
+     */
+    fun saveTriggerCache() = saveTriggerCacheCpp(id)
+
+    /**
+     * Keep the semantic expressions of the last parsed texts, so that a text that is heard again
+     * is not parsed again. (cf textToSemanticExpression)
+     * The texts are compared after the normalization of their spaces,
+     * and the expressions are cached before their merge with the context of the semantic memory.
+     * The cache is only used through this object, not through the other objects that share its native database.
+     * @param maxNbOfExpressions Size of the cache, 0 to disable the cache.
+     */
+    fun useParseCache(maxNbOfExpressions: Int = 256) = useParseCacheCpp(id, maxNbOfExpressions)
+
+    fun getParseCacheStatistics(): ParseCacheStatistics {
+        val statistics = getParseCacheStatisticsCpp(id)
+        return ParseCacheStatistics(statistics[0], statistics[1])
+    }
+
     override fun disposeImplementation(id: Int) {
         deleteLinguisticDatabase(id)
     }
 }
 
 
+data class ParseCacheStatistics(val nbOfHits: Long, val nbOfMisses: Long)
 
 
+private fun defaultLocales() = arrayOf(Locale.ENGLISH, Locale.FRENCH, Locale.JAPANESE)
+
 
 private external fun newLinguisticDatabase(
     assetManager: AssetManager,
     locales: Array<Locale>,
-    linguisticDatabasesRootFolder: String
+    linguisticDatabasesRootFolder: String,
+    useMemoryMappedAssets: Boolean,
+    loadLanguagesOnDemand: Boolean
 ): Int
 
-private external fun deleteLinguisticDatabase(linguisticDatabaseId: Int)
+private external fun newLinguisticDatabaseFromFiles(
+    locales: Array<Locale>,
+    linguisticDatabasesFolder: String,
+    loadLanguagesOnDemand: Boolean
+): Int
+
+private external fun preloadLanguagesCpp(linguisticDatabaseId: Int, locales: Array<Locale>)
 
+private external fun useTriggerCacheCpp(linguisticDatabaseId: Int, cacheFilename: String, libraryVersion: String)
+
+private external fun saveTriggerCacheCpp(linguisticDatabaseId: Int)
+
+private external fun useParseCacheCpp(linguisticDatabaseId: Int, maxNbOfExpressions: Int)
+
+private external fun getParseCacheStatisticsCpp(linguisticDatabaseId: Int): LongArray
+
+private external fun deleteLinguisticDatabase(linguisticDatabaseId: Int)
@@ -80,6 +80,8 @@ private external fun isAProperNoun(text: String, linguisticDatabaseId: Int): Boo
  * @param semanticMemory Semantic memory.
  * @param linguisticDatabase Linguistic database for the linguistic processing.
  * @return The semantic wrapper that represents the expression in the memory.
+ * There is no consuming variant: the expression is still read after the informing, to fill
+ * the parameters of the resources of the reactions, so the memory always gets a copy of it.
  */
 external fun inform(
     semanticExpression: SemanticExpression,
@@ -104,7 +106,33 @@ external fun informAxiom(
     linguisticDatabase: LinguisticDatabase
 ): ExpressionWithLinks?
 
+/**
+ * Same as informAxiom but the semantic expression is moved into the memory instead of being copied.
+ * The semantic expression is disposed by this function.
+ */
+fun informAxiomAndConsume(
+    semanticExpression: SemanticExpression,
+    semanticMemory: SemanticMemory,
+    linguisticDatabase: LinguisticDatabase
+): ExpressionWithLinks? =
+    try {
+        informAxiomAndConsumeCpp(semanticExpression, semanticMemory, linguisticDatabase)
+    } finally {
+        semanticExpression.dispose()
+    }
 
+private external fun informAxiomAndConsumeCpp(
+    semanticExpression: SemanticExpression,
+    semanticMemory: SemanticMemory,
+    linguisticDatabase: LinguisticDatabase
+): ExpressionWithLinks?
+
+
+/**
+ * React to a semantic expression and give the reaction to the outputter.
+ * The reaction gets a copy of the expression, because the outputter reads the original to fill the parameters
+ * of the resources. (so a consuming variant would not avoid the copy)
+ */
 fun react(
     semanticExpression: SemanticExpression,
     locale: Locale,
@@ -126,6 +154,10 @@ fun react(
 }
 
 
+/**
+ * Try the operators in the order of the array until one of them reacts.
+ * Each operator that takes the expression gets its own copy, and the original is kept for the outputter. (cf react)
+ */
 fun callOperators(
     operators: Array<SemanticOperator>,
     semanticExpression: SemanticExpression,
@@ -208,6 +240,27 @@ external fun answer(
     linguisticDatabase: LinguisticDatabase
 ): SemanticExpression?
 
+/**
+ * Same as answer but the semantic expression is given to the answering instead of being copied.
+ * The semantic expression is disposed by this function.
+ */
+fun answerAndConsume(
+    semanticExpression: SemanticExpression,
+    semanticMemory: SemanticMemory,
+    linguisticDatabase: LinguisticDatabase
+): SemanticExpression? =
+    try {
+        answerAndConsumeCpp(semanticExpression, semanticMemory, linguisticDatabase)
+    } finally {
+        semanticExpression.dispose()
+    }
+
+private external fun answerAndConsumeCpp(
+    semanticExpression: SemanticExpression,
+    semanticMemory: SemanticMemory,
+    linguisticDatabase: LinguisticDatabase
+): SemanticExpression?
+
 
 /**
  * Converts a semantic expression at imperative form to his implementation for execution.
@@ -303,11 +356,27 @@ external fun allowToInformTheUserHowToTeach(
 external fun getStringReportOfTheNumberOfObjectsInMemoryToSpotLeakForDebug(): String
 
 
+/**
+ * Get the language of a text: "fr", "en", "ja", or "un" if the language is unknown.
+ * The script and the frequent letter sequences of the text settle the obvious cases without
+ * looking in the dictionaries, and the languages of the last texts are kept in a cache.
+ * If the linguistic database loads its languages on demand, these obvious cases are also detected
+ * for the languages that are not loaded yet, the other texts only for the loaded languages.
+ */
 external fun getLocaleFromText(
     text: String,
     linguisticDatabase: LinguisticDatabase
 ): String
 
+/**
+ * Same as getLocaleFromText for several texts (e.g. the hypotheses of a speech recognition),
+ * the texts that need the dictionaries are processed in parallel.
+ */
+external fun getLocalesFromTexts(
+    texts: Array<String>,
+    linguisticDatabase: LinguisticDatabase
+): Array<String>
+
 
 
 private external fun reactCpp(
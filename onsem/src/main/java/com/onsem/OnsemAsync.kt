@@ -0,0 +1,230 @@
+package com.onsem
+
+import kotlinx.coroutines.CancellableContinuation
+import kotlinx.coroutines.ExperimentalCoroutinesApi
+import kotlinx.coroutines.suspendCancellableCoroutine
+import kotlinx.coroutines.withTimeoutOrNull
+import java.util.*
+import kotlin.coroutines.resumeWithException
+
+
+/**
+ * Receive the result of an operation run on the native worker threads.
+ * The operation is skipped if it is cancelled before its start.
+ */
+internal class NativeCallback(private val continuation: CancellableContinuation<Any?>) {
+    @Volatile
+    @JvmField
+    var isCancelled = false
+
+    @ExperimentalCoroutinesApi
+    fun onSuccess(result: Any?) {
+        // The continuation can be cancelled until the resume, so the result is disposed by the resume itself
+        // if it is ignored
+        continuation.resume(result) {
+            (result as? DisposableWithId)?.dispose() // Nobody waits for the result anymore
+        }
+    }
+
+    fun onFailure(error: Throwable) {
+        if (continuation.isActive)
+            continuation.resumeWithException(error)
+    }
+}
+
+/**
+ * The cancellation of the coroutine (e.g. with withTimeout) cancels the operation if it is not started yet.
+ * An operation that is already running cannot be interrupted, its result is then ignored.
+ */
+private suspend fun runOnNativeWorker(submit: (NativeCallback) -> Unit): Any? =
+    suspendCancellableCoroutine { continuation ->
+        val callback = NativeCallback(continuation)
+        continuation.invokeOnCancellation { callback.isCancelled = true }
+        submit(callback)
+    }
+
+
+/*
+ * The functions of this file run the operations on a pool of native threads instead of the thread of the caller.
+ * The operations on the same semantic memory are run one at a time, in the order of the calls.
+ * The objects given as parameters must not be disposed before the end of the operation.
+ */
+
+/**
+ * Same as inform but run on the native worker threads.
+ */
+suspend fun informAsync(
+    semanticExpression: SemanticExpression,
+    locale: Locale,
+    semanticMemory: SemanticMemory,
+    linguisticDatabase: LinguisticDatabase,
+    outputter: JiniOutputter,
+    informAboutWhatWasDone: Boolean
+): ExpressionWithLinks? =
+    runOnNativeWorker {
+        submitInform(semanticExpression, locale, semanticMemory, linguisticDatabase, outputter,
+            informAboutWhatWasDone, it)
+    } as ExpressionWithLinks?
+
+/**
+ * Same as react but run on the native worker threads.
+ */
+suspend fun reactAsync(
+    semanticExpression: SemanticExpression,
+    locale: Locale,
+    semanticMemory: SemanticMemory,
+    linguisticDatabase: LinguisticDatabase,
+    outputter: JiniOutputter,
+    informAboutWhatWasDone: Boolean
+): ContextualAnnotation =
+    getContextualAnnotationFromStr(runOnNativeWorker {
+        submitReact(semanticExpression, locale, semanticMemory, linguisticDatabase, outputter,
+            informAboutWhatWasDone, it)
+    } as String?)
+
+/**
+ * Same as callOperators but run on the native worker threads.
+ */
+suspend fun callOperatorsAsync(
+    operators: Array<SemanticOperator>,
+    semanticExpression: SemanticExpression,
+    locale: Locale,
+    semanticMemory: SemanticMemory,
+    linguisticDatabase: LinguisticDatabase,
+    outputter: JiniOutputter
+): ContextualAnnotation =
+    getContextualAnnotationFromStr(runOnNativeWorker {
+        submitCallOperators(operators, semanticExpression, locale, semanticMemory, linguisticDatabase,
+            outputter, it)
+    } as String?)
+
+/*
+ * The variants with a deadline return a fallback result if the operation does not end within timeoutMs
+ * milliseconds. The time is counted from the call, so it includes the wait behind the previous operations
+ * of the same semantic memory.
+ * An operation that is not started at the deadline is skipped, so it does not modify the semantic memory.
+ * An operation that is already running CANNOT be interrupted: after the deadline it still modifies the
+ * semantic memory and fills the outputter, and the next operations of the memory wait for its end.
+ * So the latency of the caller is bounded, but not the time of the operations of the memory, and the
+ * outputter of an operation that returned its fallback must not be read.
+ */
+
+/**
+ * Same as informAsync, but return fallback if the information is not done within timeoutMs milliseconds.
+ */
+suspend fun informAsyncWithDeadline(
+    semanticExpression: SemanticExpression,
+    locale: Locale,
+    semanticMemory: SemanticMemory,
+    linguisticDatabase: LinguisticDatabase,
+    outputter: JiniOutputter,
+    informAboutWhatWasDone: Boolean,
+    timeoutMs: Long,
+    fallback: ExpressionWithLinks? = null
+): ExpressionWithLinks? =
+    withTimeoutOrNull(timeoutMs) {
+        // Wrapped, so that a null result is not taken for a timeout
+        listOf(informAsync(semanticExpression, locale, semanticMemory, linguisticDatabase, outputter,
+            informAboutWhatWasDone))
+    }.let { if (it != null) it.first() else fallback }
+
+/**
+ * Same as reactAsync, but return fallback if the reaction is not done within timeoutMs milliseconds.
+ */
+suspend fun reactAsyncWithDeadline(
+    semanticExpression: SemanticExpression,
+    locale: Locale,
+    semanticMemory: SemanticMemory,
+    linguisticDatabase: LinguisticDatabase,
+    outputter: JiniOutputter,
+    informAboutWhatWasDone: Boolean,
+    timeoutMs: Long,
+    fallback: ContextualAnnotation = ContextualAnnotation.EMPTY
+): ContextualAnnotation =
+    withTimeoutOrNull(timeoutMs) {
+        reactAsync(semanticExpression, locale, semanticMemory, linguisticDatabase, outputter,
+            informAboutWhatWasDone)
+    } ?: fallback
+
+/**
+ * Same as callOperatorsAsync, but return fallback if the operators are not done within timeoutMs milliseconds.
+ */
+suspend fun callOperatorsAsyncWithDeadline(
+    operators: Array<SemanticOperator>,
+    semanticExpression: SemanticExpression,
+    locale: Locale,
+    semanticMemory: SemanticMemory,
+    linguisticDatabase: LinguisticDatabase,
+    outputter: JiniOutputter,
+    timeoutMs: Long,
+    fallback: ContextualAnnotation = ContextualAnnotation.EMPTY
+): ContextualAnnotation =
+    withTimeoutOrNull(timeoutMs) {
+        callOperatorsAsync(operators, semanticExpression, locale, semanticMemory, linguisticDatabase, outputter)
+    } ?: fallback
+
+/**
+ * Same as answer but run on the native worker threads.
+ */
+suspend fun answerAsync(
+    semanticExpression: SemanticExpression,
+    semanticMemory: SemanticMemory,
+    linguisticDatabase: LinguisticDatabase
+): SemanticExpression? =
+    runOnNativeWorker {
+        submitAnswer(semanticExpression, semanticMemory, linguisticDatabase, it)
+    } as SemanticExpression?
+
+/**
+ * Answer on the native worker threads, and answer by the negative (cf notKnowing)
+ * if no answer is found or if the answer takes more than timeoutMs milliseconds.
+ * It bounds the time of a conversational turn even when the answering is long.
+ * (an answering that is already running is not interrupted, it only delays the next operations of the memory)
+ */
+suspend fun answerAsyncOrNotKnowing(
+    semanticExpression: SemanticExpression,
+    semanticMemory: SemanticMemory,
+    linguisticDatabase: LinguisticDatabase,
+    timeoutMs: Long
+): SemanticExpression? =
+    withTimeoutOrNull(timeoutMs) {
+        answerAsync(semanticExpression, semanticMemory, linguisticDatabase)
+    } ?: notKnowing(semanticExpression, semanticMemory, linguisticDatabase)
+
+
+private external fun submitInform(
+    semanticExpression: SemanticExpression,
+    locale: Locale,
+    semanticMemory: SemanticMemory,
+    linguisticDatabase: LinguisticDatabase,
+    outputter: JiniOutputter,
+    informAboutWhatWasDone: Boolean,
+    callback: NativeCallback
+)
+
+private external fun submitReact(
+    semanticExpression: SemanticExpression,
+    locale: Locale,
+    semanticMemory: SemanticMemory,
+    linguisticDatabase: LinguisticDatabase,
+    outputter: JiniOutputter,
+    informAboutWhatWasDone: Boolean,
+    callback: NativeCallback
+)
+
+private external fun submitCallOperators(
+    operators: Array<SemanticOperator>,
+    semanticExpression: SemanticExpression,
+    locale: Locale,
+    semanticMemory: SemanticMemory,
+    linguisticDatabase: LinguisticDatabase,
+    outputter: JiniOutputter,
+    callback: NativeCallback
+)
+
+private external fun submitAnswer(
+    semanticExpression: SemanticExpression,
+    semanticMemory: SemanticMemory,
+    linguisticDatabase: LinguisticDatabase,
+    callback: NativeCallback
+)
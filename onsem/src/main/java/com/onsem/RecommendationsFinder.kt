@@ -1,10 +1,11 @@
 package com.onsem
 
+import java.io.File
 import java.util.*
 
-class RecommendationsFinder(
-    linguisticDatabase: LinguisticDatabase
-) : DisposableWithId(newRecommendationsFinder(linguisticDatabase.id)) {
+class RecommendationsFinder internal constructor(id: Int) : DisposableWithId(id) {
+
+    constructor(linguisticDatabase: LinguisticDatabase) : this(newRecommendationsFinder(linguisticDatabase.id))
 
     companion object {
         init {
@@ -25,15 +26,47 @@ class RecommendationsFinder(
         addRecommendation(this, text, recommendationId, locale, linguisticDatabase)
     }
 
+    fun addRecommendationsBulk(
+        texts: Array<String>,
+        recommendationIds: Array<String>,
+        locale: Locale,
+        linguisticDatabase: LinguisticDatabase
+    ) {
+        addRecommendationsBulk(this, texts, recommendationIds, locale, linguisticDatabase)
+    }
+
+    fun save(file: File) {
+        saveRecommendationsFinder(this, file)
+    }
+
     fun getRecommendations(
         semanticExpression: SemanticExpression,
         linguisticDatabase: LinguisticDatabase
     ) : Array<String> {
         return getRecommendations(this, semanticExpression, linguisticDatabase)
     }
+
+    fun getTopRecommendations(
+        semanticExpression: SemanticExpression,
+        linguisticDatabase: LinguisticDatabase,
+        maxNbOfRecommendations: Int = 3,
+        minScore: Int = Int.MIN_VALUE,
+        useIndex: Boolean = false
+    ) : Array<Recommendation> {
+        return getTopRecommendations(this, semanticExpression, linguisticDatabase, maxNbOfRecommendations, minScore,
+            useIndex)
+    }
 }
 
 
+/**
+ * A recommendation found for a semantic expression.
+ * @param id Id given to addRecommendation.
+ * @param score Score of the matching with the semantic expression, the higher the better.
+ */
+data class Recommendation(val id: String, val score: Int)
+
+
 
 private external fun newRecommendationsFinder(linguisticDatabaseId: Int): Int
 
@@ -47,9 +80,80 @@ external fun addRecommendation(
     linguisticDatabase: LinguisticDatabase
 )
 
-external fun getRecommendations(
+/**
+ * Add several recommendations at once.
+ * The texts are parsed in parallel, and the recommendations finder is only locked to insert them,
+ * so it is much faster than calling addRecommendation for each text.
+ * @param texts Texts of the recommendations.
+ * @param recommendationIds Id of the recommendation of each text, so it has the same size as texts.
+ */
+external fun addRecommendationsBulk(
+    recommendationsFinder: RecommendationsFinder,
+    texts: Array<String>,
+    recommendationIds: Array<String>,
+    locale: Locale,
+    linguisticDatabase: LinguisticDatabase
+)
+
+/**
+ * Write the recommendations of a recommendations finder in a file.
+ * The file is replaced atomically, so a crash during the saving keeps the previous file.
+ */
+fun saveRecommendationsFinder(recommendationsFinder: RecommendationsFinder, file: File) =
+    saveRecommendationsFinderCpp(recommendationsFinder, file.absolutePath)
+
+/**
+ * Construct a recommendations finder from a file written by saveRecommendationsFinder,
+ * without parsing the texts of its recommendations again.
+ * The languages of the recommendations are loaded in the linguistic database if they are loaded on demand.
+ */
+fun loadRecommendationsFinder(file: File, linguisticDatabase: LinguisticDatabase) =
+    RecommendationsFinder(loadRecommendationsFinderCpp(file.absolutePath, linguisticDatabase))
+
+private external fun saveRecommendationsFinderCpp(recommendationsFinder: RecommendationsFinder, filename: String)
+private external fun loadRecommendationsFinderCpp(filename: String, linguisticDatabase: LinguisticDatabase): Int
+
+/**
+ * Get the ids of the 3 best recommendations for a semantic expression, from the best one.
+ */
+fun getRecommendations(
     recommendationsFinder: RecommendationsFinder,
     semanticExpression: SemanticExpression,
     linguisticDatabase: LinguisticDatabase
-) : Array<String>
+) : Array<String> =
+    getTopRecommendations(recommendationsFinder, semanticExpression, linguisticDatabase)
+        .map { it.id }.toTypedArray()
+
+/**
+ * Get the best recommendations for a semantic expression, from the best one.
+ * By default, the recommendations are scored by onsem, as in getRecommendations.
+ * For the same score, the recommendations are sorted by id.
+ * @param maxNbOfRecommendations Maximum number of recommendations returned.
+ * @param minScore The recommendations below this score are not returned.
+ * @param useIndex Score the recommendations with the index of their groundings (concepts, agents and words)
+ * instead of comparing their semantic expressions. It is much faster for the big sets of recommendations,
+ * but the scores are not the same: a recommendation scores the sum of the coefficients of the groundings
+ * it shares with the semantic expression, and only the recommendations that share a grounding are returned.
+ * So the index gives another ranking than the comparison of the semantic expressions of onsem, the two modes
+ * can return different recommendations in a different order, and comparing their durations compares two rankings.
+ */
+fun getTopRecommendations(
+    recommendationsFinder: RecommendationsFinder,
+    semanticExpression: SemanticExpression,
+    linguisticDatabase: LinguisticDatabase,
+    maxNbOfRecommendations: Int = 3,
+    minScore: Int = Int.MIN_VALUE,
+    useIndex: Boolean = false
+) : Array<Recommendation> =
+    getTopRecommendationsCpp(recommendationsFinder, semanticExpression, linguisticDatabase,
+        maxNbOfRecommendations, minScore, useIndex)
+
+private external fun getTopRecommendationsCpp(
+    recommendationsFinder: RecommendationsFinder,
+    semanticExpression: SemanticExpression,
+    linguisticDatabase: LinguisticDatabase,
+    maxNbOfRecommendations: Int,
+    minScore: Int,
+    useIndex: Boolean
+) : Array<Recommendation>
 
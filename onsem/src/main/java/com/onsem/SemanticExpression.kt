@@ -81,6 +81,25 @@ external fun textToSemanticExpression(
 ): SemanticExpression
 
 
+/**
+ * Convert several texts to semantic expressions.
+ * The texts are parsed in parallel, then they are merged with the context of the semantic memory
+ * in the order of the array, with only one lock of the semantic memory.
+ * @param texts Texts to convert. (e.g. a dialog corpus or the n-best results of a speech recognition)
+ * @param textProcessingContext Context for the conversion (author of the texts, language, ...)
+ * @param semanticMemory Semantic Memory.
+ * @param linguisticDatabase Linguistic database.
+ * @return Semantic expressions corresponding to the input texts, in the same order.
+ */
+external fun textsToSemanticExpressions(
+    texts: Array<String>,
+    textProcessingContext: TextProcessingContext,
+    sourceEnum: SemanticSourceEnum,
+    semanticMemory: SemanticMemory,
+    linguisticDatabase: LinguisticDatabase
+): Array<SemanticExpression>
+
+
 /**
  * Convert a semantic expression to a text.
  * @param semanticExpression Semantic expression to convert.
@@ -96,6 +115,29 @@ external fun semanticExpressionToText(
     linguisticDatabase: LinguisticDatabase
 ): String
 
+/**
+ * Same as semanticExpressionToText but the semantic expression is given to the conversion instead of being copied.
+ * The semantic expression is disposed by this function.
+ */
+fun semanticExpressionToTextAndConsume(
+    semanticExpression: SemanticExpression,
+    locale: Locale,
+    semanticMemory: SemanticMemory,
+    linguisticDatabase: LinguisticDatabase
+): String =
+    try {
+        semanticExpressionToTextAndConsumeCpp(semanticExpression, locale, semanticMemory, linguisticDatabase)
+    } finally {
+        semanticExpression.dispose()
+    }
+
+private external fun semanticExpressionToTextAndConsumeCpp(
+    semanticExpression: SemanticExpression,
+    locale: Locale,
+    semanticMemory: SemanticMemory,
+    linguisticDatabase: LinguisticDatabase
+): String
+
 
 data class TextWithPotentialLabel(
     val text: String,
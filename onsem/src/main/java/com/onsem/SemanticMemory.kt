@@ -1,16 +1,19 @@
 package com.onsem
 
+import java.io.File
 import java.lang.RuntimeException
 
 
 /**
  * A semantic memory that can be used to store an history and used to retrieve information.
  */
-class SemanticMemory : DisposableWithId(newMemory()) {
+class SemanticMemory internal constructor(id: Int) : DisposableWithId(id) {
 
     private var counterOfUsage = 0
     private var isUsingSubMemory: SemanticMemory? = null
 
+    constructor() : this(newMemory())
+
     companion object {
         init {
             ensureInitialized()
@@ -77,6 +80,16 @@ class SemanticMemory : DisposableWithId(newMemory()) {
         return linkUserIdToFullName(id, userId, fullname, linguisticDatabase)
     }
 
+    /**
+     * Keep the texts generated with this memory (e.g. the answers of the triggers), so that the same
+     * semantic expressions are not converted to text again.
+     * The cache is emptied when the knowledge of the memory or of its sub memory changes.
+     * @param maxNbOfTexts Maximum number of texts kept, 0 to remove the cache.
+     */
+    fun useSynthesisCache(maxNbOfTexts: Int = 256) {
+        useSynthesisCache(id, maxNbOfTexts)
+    }
+
     override fun disposeImplementation(id: Int) {
         if (counterOfUsage > 0)
             throw RuntimeException("$counterOfUsage other memory(s) is pointing to this one, please dispose the memory(s) that is using this memory first. (done by function linkASubMemory)")
@@ -86,8 +99,53 @@ class SemanticMemory : DisposableWithId(newMemory()) {
 }
 
 
+/**
+ * Write the content of a semantic memory in a file, the content of its sub memory is not written.
+ * The file is replaced atomically, so a crash during the saving keeps the previous snapshot.
+ */
+fun saveMemorySnapshot(semanticMemory: SemanticMemory, snapshotFile: File) =
+    saveMemorySnapshotCpp(semanticMemory.id, snapshotFile.absolutePath)
+
+/**
+ * Construct a semantic memory from a file written by saveMemorySnapshot, without replaying
+ * the operations that constructed the saved memory.
+ * The sub memory is not restored, it has to be linked again with linkASubMemory.
+ */
+fun loadMemorySnapshot(snapshotFile: File, linguisticDatabase: LinguisticDatabase) =
+    SemanticMemory(loadMemorySnapshotCpp(snapshotFile.absolutePath, linguisticDatabase))
+
+/**
+ * Construct a semantic memory that records its modifications in a journal, so that it survives a crash
+ * without writing all its content at each modification.
+ * The memory is restored from the snapshot file and the journal file when they exist.
+ * The informations, the triggers and the current user id are recorded in the journal,
+ * and a snapshot of the whole memory is written compactionIntervalMs after the first modification
+ * since the previous snapshot. The other modifications (e.g. react, teachBehavior or callOperators)
+ * are not in the journal, they are saved by this snapshot and by the disposal of the memory.
+ * Do not write another snapshot (cf saveMemorySnapshot) in the snapshot file of a journal.
+ */
+fun openMemoryWithJournal(
+    snapshotFile: File,
+    journalFile: File,
+    linguisticDatabase: LinguisticDatabase,
+    compactionIntervalMs: Long = 60000
+) = SemanticMemory(
+    openMemoryWithJournalCpp(
+        snapshotFile.absolutePath, journalFile.absolutePath, compactionIntervalMs, linguisticDatabase
+    )
+)
+
 
 private external fun newMemory(): Int
+private external fun saveMemorySnapshotCpp(memoryId: Int, snapshotFilename: String)
+private external fun loadMemorySnapshotCpp(snapshotFilename: String, linguisticDatabase: LinguisticDatabase): Int
+private external fun openMemoryWithJournalCpp(
+    snapshotFilename: String,
+    journalFilename: String,
+    compactionIntervalMs: Long,
+    linguisticDatabase: LinguisticDatabase
+): Int
+private external fun useSynthesisCache(memoryId: Int, maxNbOfTexts: Int)
 private external fun linkASubMemory(mainSemanticId: Int, subSemanticId: Int)
 private external fun setCurrentUserId(memoryId: Int, currentUserId: String)
 private external fun getCurrentUserId(memoryId: Int): String
@@ -1,5 +1,7 @@
 package com.onsem
 
+import com.fasterxml.jackson.module.kotlin.jacksonObjectMapper
+import java.io.InputStream
 import java.util.*
 
 
@@ -24,6 +26,58 @@ external fun addTriggerToAResource(
     linguisticDatabase: LinguisticDatabase
 )
 
+/**
+ * Trigger to add with addTriggers.
+ * The trigger either answers a text (answer) or a resource (resourceType, resourceId and parameters).
+ */
+data class TriggerSpec(
+    val trigger: String,
+    val answer: String = "",
+    val resourceType: String = "",
+    val resourceId: String = "",
+    val parameters: Map<String, Array<String>> = mapOf()
+)
+
+/**
+ * Read a list of triggers from a JSON array of TriggerSpec objects.
+ * ex: [{"trigger": "Avance", "resourceType": "mission", "resourceId": "avance-id",
+ *       "parameters": {"distance": ["combien de mètres"]}}]
+ */
+fun readTriggerSpecs(jsonStream: InputStream): Array<TriggerSpec> =
+    jacksonObjectMapper().readValue(jsonStream, Array<TriggerSpec>::class.java)
+
+/**
+ * Add several triggers, it is faster than calling addTrigger or addTriggerToAResource for each trigger.
+ * The texts are parsed in parallel without locking the semantic memory,
+ * then the triggers are added in the order of the array with only one lock of the semantic memory.
+ */
+fun addTriggers(
+    triggers: Array<TriggerSpec>,
+    locale: Locale,
+    semanticMemory: SemanticMemory,
+    linguisticDatabase: LinguisticDatabase
+) = addTriggersCpp(
+    triggers.map { it.trigger }.toTypedArray(),
+    triggers.map { it.answer }.toTypedArray(),
+    triggers.map { it.resourceType }.toTypedArray(),
+    triggers.map { it.resourceId }.toTypedArray(),
+    triggers.map { it.parameters }.toTypedArray(),
+    locale,
+    semanticMemory,
+    linguisticDatabase
+)
+
+private external fun addTriggersCpp(
+    triggers: Array<String>,
+    answers: Array<String>,
+    resourceTypes: Array<String>,
+    resourceIds: Array<String>,
+    parameters: Array<Map<String, Array<String>>>,
+    locale: Locale,
+    semanticMemory: SemanticMemory,
+    linguisticDatabase: LinguisticDatabase
+)
+
 external fun addPlannerActionToMemory(
     trigger: String,
     itIsAnActionId: String,
@@ -34,6 +88,11 @@ external fun addPlannerActionToMemory(
     linguisticDatabase: LinguisticDatabase
 )
 
+/**
+ * React with the answer of the trigger that matches the semantic expression.
+ * The matching gets a copy of the expression, the outputter needs the original to fill the parameters
+ * of the resources. (cf react)
+ */
 fun reactFromTrigger(
     semanticExpression: SemanticExpression,
     locale: Locale,